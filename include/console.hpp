@@ -6,7 +6,7 @@
 
 namespace ray = raylib;
 
-void ConsoleLog(std::string msg);
-void ConsoleError(std::string msg);
+void ConsoleLog(const std::string& msg);
+void ConsoleError(const std::string& msg);
 void ConsoleDraw(ray::Rectangle rec);
 void ConsoleClear();
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+
+// Row-major 2D array sized at runtime. grid[row][col] indexes it like a built-in 2D array.
+template <typename T>
+class Grid {
+private:
+	std::unique_ptr<T[]> items;
+	int rows = 0;
+	int cols = 0;
+
+public:
+	Grid() { }
+	Grid(int rows, int cols) { Resize(rows, cols); }
+	Grid(const Grid& other) { *this = other; }
+	Grid(Grid&& other) = default;
+
+	Grid& operator = (const Grid& other) {
+		if (this != &other) {
+			if (Size() != other.Size()) {
+				items.reset(new T[other.Size()]);
+			}
+			rows = other.rows;
+			cols = other.cols;
+			std::copy(other.items.get(), other.items.get() + Size(), items.get());
+		}
+		return *this;
+	}
+	Grid& operator = (Grid&& other) = default;
+
+	// Any previous contents are discarded, and the new items are value-initialized.
+	// The storage is reused when the size doesn't change.
+	void Resize(int rows, int cols) {
+		size_t size = (size_t)rows * cols;
+		if (!items || size != Size()) {
+			items.reset(new T[size]());
+		} else {
+			Fill(T());
+		}
+		this->rows = rows;
+		this->cols = cols;
+	}
+
+	void Fill(const T& value) { std::fill(items.get(), items.get() + Size(), value); }
+
+	int Rows() const { return rows; }
+	int Cols() const { return cols; }
+	size_t Size() const { return (size_t)rows * cols; }
+
+	T* operator [] (int row) { return items.get() + (size_t)row * cols; }
+	const T* operator [] (int row) const { return items.get() + (size_t)row * cols; }
+
+	bool operator == (const Grid& other) const {
+		return rows == other.rows && cols == other.cols
+			&& std::equal(items.get(), items.get() + Size(), other.items.get());
+	}
+};
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <string>
+
+typedef void (*LogHandler)(const std::string& msg);
+
+// Core code reports through these instead of a specific console, so it can run without a GUI.
+// By default messages are printed to stdout.
+void SetLogHandlers(LogHandler info_handler, LogHandler error_handler);
+void LogInfo(const std::string& msg);
+void LogError(const std::string& msg);
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Files smaller than this are read into memory instead, which is cheaper than mapping them
+#define MAPPED_FILE_MIN_MAP_SIZE (64 * 1024)
+
+// A whole file mapped read-only into memory, so it can be parsed in place without copying it.
+// Empty files fail to open.
+class MappedFile {
+private:
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+	bool mapped = false;
+	std::vector<uint8_t> buffer; // Contents of small files, kept between opens
+
+public:
+	MappedFile();
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Returns 0 if the file can't be opened or mapped. Doesn't log, so files can be opened from several threads.
+	int Open(const std::string& filename);
+	void Close();
+
+	const uint8_t* Data() const { return data; }
+	size_t Size() const { return size; }
+};
@@ -1,42 +1,109 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
-#include <raylib.h>
-#include <raylib-cpp.hpp>
 #include <vector>
 
+#include "grid.hpp"
 #include "point.hpp"
 
-namespace ray = raylib;
+// Size of a classic maze, used until a maze file says otherwise
+#define MAZE_DEFAULT_ROWS 16
+#define MAZE_DEFAULT_COLS 16
 
-#define MAZE_ROWS 16
-#define MAZE_COLS 16
-#define MAZE_CELL_SIZE 45
+// Coordinates are stored in int16_t, with edges and corners going up to the row and column count
+#define MAZE_MAX_SIZE 16384
+
+// Why a .maz file failed to load
+enum MazeFileError {
+	MAZE_FILE_OK = 0,
+	MAZE_FILE_UNREADABLE,
+	MAZE_FILE_NO_SIZE,
+	MAZE_FILE_NO_START,
+	MAZE_FILE_BAD_NUMBER,
+	MAZE_FILE_BAD_SIZE,
+	MAZE_FILE_BAD_START,
+	MAZE_FILE_MISSING_ROWS,
+	MAZE_FILE_BAD_ROW_LENGTH,
+	MAZE_FILE_BAD_CELL,
+	MAZE_FILE_EXTRA_LINES,
+	MAZE_FILE_UNKNOWN_FORMAT,
+	MAZE_FILE_BAD_LAYOUT,
+	MAZE_FILE_BAD_WALL,
+	MAZE_FILE_BAD_LINE,
+	MAZE_FILE_MISSING_CELL,
+	MAZE_FILE_TRUNCATED,
+};
+
+const char* MazeFileErrorMessage(MazeFileError error);
+
+// Maze file formats, told apart by their contents since several of them share the .maz extension
+enum MazeFormat {
+	MAZE_FORMAT_UNKNOWN = 0,
+	MAZE_FORMAT_MAZ,    // This project's .maz files
+	MAZE_FORMAT_TEXT,   // ASCII drawings of the walls
+	MAZE_FORMAT_BINARY, // A byte of wall bits per cell, like the classic 256 byte .maz files
+	MAZE_FORMAT_NUM,    // A line of wall flags per cell
+};
+
+MazeFormat DetectMazeFormat(const char* data, size_t size);
 
 class Maze {
+	friend class MazeGenerator; // Carves straight into the wall grids
+
 private:
-	bool horizontal_walls[MAZE_ROWS + 1][MAZE_COLS];
-	bool vertical_walls[MAZE_ROWS][MAZE_COLS + 1];
-	
+	int rows = 0;
+	int cols = 0;
+	Grid<bool> horizontal_walls; // (rows + 1) x cols
+	Grid<bool> vertical_walls;   // rows x (cols + 1)
+	unsigned int version = 0;
+
+	// Parsers for each format, run on a scratch Maze (see Adopt())
+	MazeFileError ParseMaz(const char* data, size_t size, Point* starting_coord, int* error_line);
+	MazeFileError ImportText(const char* data, size_t size, Point* starting_coord, int* error_line);
+	MazeFileError ImportBinary(const uint8_t* data, size_t size, Point* starting_coord);
+	MazeFileError ImportNum(const char* data, size_t size, Point* starting_coord, int* error_line, Point* error_cell);
+	void AddCellWalls(int col, int row, bool north, bool east, bool south, bool west);
+	void Adopt(Maze& parsed);
+
 public:
-	ray::Vector2 position;
 	std::vector<Point> goals;
 
-	Maze(Vector2 position);
+	Maze(int rows = MAZE_DEFAULT_ROWS, int cols = MAZE_DEFAULT_COLS);
 	~Maze();
 
-	bool Contains(Vector2 pos);
-	Point ClosestCornerTo(Vector2 pos);
-	ray::Vector2 CornerToPos(Point coord);
-	ray::Vector2 CellToPos(Point coord);
+	int Rows() const { return rows; }
+	int Cols() const { return cols; }
+	unsigned int Version() const { return version; } // Changes whenever the size or walls change
+	bool Contains(Point cell) const;
+	void Resize(int rows, int cols);
 
-	static bool IsWallValid(Point from_corner, Point to_corner);
+	bool IsWallValid(Point from_corner, Point to_corner);
 	void SetWalls(Point from_corner, Point to_corner, bool state);
 	bool WallAt(bool horizontal, Point coord);
 	void Clear();
 
-	void Draw(Color wall_clr, Color dot_clr);
-
 	int SaveToFile(std::string filename, Point starting_coord);
-	int LoadFromFile(std::string filename, Point* starting_coord);
+	int LoadFromFile(std::string filename, Point* starting_coord); // Any format DetectMazeFormat() knows
+
+	// Parse the contents of a .maz file. Doesn't log, so mazes can be parsed from several threads.
+	// On failure, error_line (if given) is set to the line at fault, and the maze and starting_coord are left
+	// as they were.
+	MazeFileError LoadFromBuffer(const char* data, size_t size, Point* starting_coord, int* error_line = nullptr);
+	// Same for any format DetectMazeFormat() knows (see maze.cpp for the formats). For MAZE_FILE_MISSING_CELL,
+	// error_cell (if given) is set to the first missing cell, as the file numbers it.
+	MazeFileError ImportFromBuffer(const char* data, size_t size, Point* starting_coord, int* error_line = nullptr,
+		Point* error_cell = nullptr);
+
+	// Binary records, as stored in .mza archives. LoadFromRecord() returns 0 if the record is invalid
+	// (including one without goals, or with the start or a goal outside the maze), without logging, so it can
+	// be used from several threads. The outer walls are always kept, whatever the record says.
+	void SaveToRecord(std::vector<uint8_t>& record, Point starting_coord);
+	int LoadFromRecord(const uint8_t* record, size_t size, Point* starting_coord);
 };
+
+// Load many maze files, spread over thread_count threads. errors gets the result for each file, and
+// failures are logged from the calling thread in file order. Returns the number of files loaded.
+int LoadMazeFiles(const std::vector<std::string>& filenames, std::vector<Maze>& mazes,
+	std::vector<Point>& starting_coords, std::vector<MazeFileError>& errors, int thread_count);
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "maze.hpp"
+#include "point.hpp"
+
+// .mza archives hold any number of mazes as binary records (see Maze::SaveToRecord()):
+// - Header: "MZA1", then the number of mazes (uint32)
+// - Index: the file offset of each record (uint64), then the offset of the end of the last record
+// - The records, back to back
+// All numbers are little-endian.
+
+#define MAZE_ARCHIVE_MAGIC "MZA1"
+#define MAZE_ARCHIVE_HEADER_SIZE 8
+
+// Read-only access to a .mza archive. The file is memory-mapped, and mazes are decoded
+// straight from the mapping, so opening even a huge archive reads nothing but its header.
+class MazeArchive {
+private:
+	MappedFile file;
+	int count = 0;
+
+	uint64_t RecordOffset(int index) const;
+
+public:
+	MazeArchive();
+	~MazeArchive();
+	MazeArchive(const MazeArchive&) = delete;
+	MazeArchive& operator=(const MazeArchive&) = delete;
+
+	int Open(std::string filename);
+	void Close();
+	int Count() const { return count; }
+
+	// Load the maze at index, returns 0 if its record is invalid. Several threads may load at once.
+	int Load(int index, Maze* maze, Point* starting_coord) const;
+};
+
+// Collects mazes into a .mza archive
+class MazeArchiveWriter {
+private:
+	std::vector<uint8_t> records;
+	std::vector<uint64_t> record_ends;
+
+public:
+	int Count() const { return (int)record_ends.size(); }
+	void Add(Maze& maze, Point starting_coord);
+	int SaveToFile(std::string filename);
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "maze.hpp"
+#include "point.hpp"
+
+// Interior walls removed per cell by the loops and competition algorithms, after the perfect maze is carved
+#define MAZE_GENERATOR_LOOPS_PER_CELL 0.05
+
+enum MazeAlgorithm {
+	MAZE_ALGORITHM_BACKTRACKER = 0, // Perfect maze with long winding corridors
+	MAZE_ALGORITHM_KRUSKAL,         // Perfect maze with many short dead ends
+	MAZE_ALGORITHM_BRAID,           // Backtracker maze with every dead end opened into a loop
+	MAZE_ALGORITHM_LOOPS,           // Backtracker maze with some extra walls removed, giving multiple loops
+	MAZE_ALGORITHM_COMPETITION,     // Start in a corner, goal area with a single entrance, some loops
+	MAZE_ALGORITHM_COUNT
+};
+
+const char* MazeAlgorithmName(MazeAlgorithm algorithm);
+// Returns 0 if name isn't one of the algorithm names
+int ParseMazeAlgorithm(const std::string& name, MazeAlgorithm* algorithm);
+
+// Fills mazes with procedurally generated layouts. The same algorithm, size and seed always give the same
+// maze, on any platform. Scratch space is kept between mazes, so generating many mazes doesn't allocate.
+// Each thread needs its own generator.
+class MazeGenerator {
+private:
+	uint64_t state[4]; // xoshiro256** random number generator
+	int rows = 0;
+	int cols = 0;
+	Maze* maze = nullptr;
+	std::vector<uint8_t> visited;
+	std::vector<int> stack;
+	std::vector<int> edges; // Interior walls, as cell * 2 (+ 1 for the wall to the east, else south)
+	std::vector<int> parents;
+
+	uint64_t Next();
+	int Below(int n);
+	void Seed(uint64_t seed);
+
+	bool IsWall(int edge);
+	void RemoveWall(int edge);
+	int EdgeBetween(int cell, int neighbor);
+	int Neighbors(int cell, int* neighbors);
+	int FindSet(int cell);
+
+	void Backtrack(int start);
+	void Kruskal();
+	void Braid();
+	void AddLoops(bool keep_marked_closed);
+	void Competition();
+
+public:
+	MazeGenerator();
+	~MazeGenerator();
+
+	// Resize maze to rows x cols and generate it. The goals are the center cells, as set by Maze::Resize().
+	// The start is the bottom left corner.
+	void Generate(Maze* maze, int rows, int cols, MazeAlgorithm algorithm, uint64_t seed, Point* starting_coord);
+};
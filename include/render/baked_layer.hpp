@@ -0,0 +1,32 @@
+#pragma once
+
+#include <raylib.h>
+
+// Drawing that rarely changes, cached in a render texture so each frame only blits it.
+// Draw the contents in white between Begin() and End(), and pick the color when blitting.
+// The texture is created on first use (after the window exists) and freed with the window.
+class BakedLayer {
+private:
+	RenderTexture2D texture = { 0 };
+	bool valid = false;
+
+public:
+	int padding; // Pixels around the drawn area, for lines and corners that stick out of it
+
+	BakedLayer(int padding);
+	~BakedLayer();
+
+	// Mark the contents as outdated, so the next Begin() redraws them
+	void Invalidate();
+
+	// Returns true if the contents must be redrawn, in which case the layer (width x height plus padding)
+	// is cleared and drawn into until End()
+	bool Begin(int width, int height);
+	void End();
+
+	// Where the top left of the drawn area is while drawing into the layer
+	Vector2 Origin();
+
+	// Blit the layer with its drawn area's top left at position
+	void Draw(Vector2 position, Color tint);
+};
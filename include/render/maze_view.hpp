@@ -0,0 +1,47 @@
+#pragma once
+
+#include <raylib.h>
+#include <raylib-cpp.hpp>
+
+#include "maze.hpp"
+#include "point.hpp"
+#include "render/baked_layer.hpp"
+
+namespace ray = raylib;
+
+// Side length of the square the maze is scaled to fit in (45 pixels per cell for a 16x16 maze)
+#define MAZE_VIEW_SIZE 720.0f
+
+// Room around baked maze layers for the corner dots, which stick out of the maze
+#define MAZE_LAYER_PADDING 4
+
+// Places a maze on the screen and draws it.
+// The walls and corners are baked into layers, which are only redrawn when the maze changes.
+class MazeView {
+private:
+	BakedLayer walls_layer = BakedLayer(MAZE_LAYER_PADDING);
+	BakedLayer corners_layer = BakedLayer(MAZE_LAYER_PADDING);
+	unsigned int baked_maze_version = 0;
+
+	void DrawWalls(ray::Vector2 origin, float cell_size);
+	void DrawCorners(ray::Vector2 origin, float cell_size);
+
+public:
+	Maze* maze;
+	ray::Vector2 position;
+
+	MazeView(Maze* maze, ray::Vector2 position);
+	~MazeView();
+
+	float CellSize();
+	bool Contains(Vector2 pos);
+	Point ClosestCornerTo(Vector2 pos);
+	ray::Vector2 CornerToPos(Point coord);
+	ray::Vector2 CellToPos(Point coord);
+
+	// Size in pixels of the area taken by the maze, including its bottom and right walls
+	int PixelWidth();
+	int PixelHeight();
+
+	void Draw(Color wall_clr, Color dot_clr);
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "solver_view.hpp"
+#include "solver/simple_solver.hpp"
+
+class SimpleSolverView : public SolverView {
+private:
+	SimpleSolver* solver;
+	MazeView* maze_view;
+
+	// Known walls, redrawn when the solver finds new ones
+	BakedLayer known_walls_layer = BakedLayer(MAZE_LAYER_PADDING);
+	unsigned int baked_walls_version = 0;
+	float baked_cell_size = 0.0f;
+
+	// Floodfill values, laid out again only when they change
+	BakedLayer floodfill_layer = BakedLayer(FLOODFILL_LAYER_PADDING);
+	unsigned int baked_floodfill_version = 0;
+	float baked_floodfill_cell_size = 0.0f;
+
+	void DrawKnownWalls(ray::Vector2 origin, float cell_size);
+	void DrawFloodfillValues(ray::Vector2 origin, float cell_size, Font floodfill_font);
+	void DrawPath(const std::vector<Point>& path, Color clr);
+
+public:
+	SimpleSolverView(SimpleSolver* solver, MazeView* maze_view);
+	~SimpleSolverView();
+
+	void Draw(bool show_floodfill_vals, Font floodfill_font) override;
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <raylib.h>
+
+#include "render/maze_view.hpp"
+
+// Room around the floodfill value layer, for labels of the outer edges that stick out of the maze
+#define FLOODFILL_LAYER_PADDING 32
+
+// Floodfill values are not shown when cells are smaller than this, as they would not be readable
+#define FLOODFILL_MIN_CELL_SIZE 12.0f
+
+// Draws a solver's knowledge of the maze on top of a MazeView
+class SolverView {
+public:
+	virtual ~SolverView() = default;
+	virtual void Draw(bool show_floodfill_vals, Font floodfill_font) = 0;
+};
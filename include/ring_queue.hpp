@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// FIFO queue with a fixed capacity, allocated once up front.
+// Pushing and popping never allocate, so it can be reused across floodfills.
+template <typename T>
+class RingQueue {
+private:
+	std::vector<T> items;
+	size_t head = 0;
+	size_t count = 0;
+
+public:
+	RingQueue() { }
+	RingQueue(size_t capacity) : items(capacity) { }
+
+	// Discards the queued items
+	void Resize(size_t capacity) {
+		items.resize(capacity);
+		Clear();
+	}
+
+	bool Empty() const { return count == 0; }
+	size_t Size() const { return count; }
+	size_t Capacity() const { return items.size(); }
+	void Clear() { head = count = 0; }
+
+	// The caller guarantees that the queue never holds more than Capacity() items
+	void Push(const T& item) {
+		size_t tail = head + count;
+		items[tail < items.size() ? tail : tail - items.size()] = item;
+		count++;
+	}
+
+	T Pop() {
+		T item = items[head];
+		head = head + 1 < items.size() ? head + 1 : 0;
+		count--;
+		return item;
+	}
+};
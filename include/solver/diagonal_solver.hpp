@@ -1,16 +1,23 @@
 #pragma once
 
+#include "grid.hpp"
 #include "solver.hpp"
 #include "direction.hpp"
+#include "solver/flood_cache.hpp"
+#include "solver/motion_model.hpp"
 
 #define FF_VAL_TO_FLOAT(n) (((n) / 3.0f) - 1.0f)
 #define FF_VAL_FROM_FLOAT(x) (((x) + 1.0f) * 3.0f)
 
+// Floodfill queue entries reserved per edge. Edges can be pushed many times per flood,
+// so this is well above the largest floods of the bundled mazes.
+#define FLOOD_QUEUE_RESERVE_PER_EDGE 128
+
 struct Edge {
-	uint16_t ff_val : 10; // (0 to 1023) / 3.0f - 1.0f maps to (-1.0f to 340.0f)
-	uint8_t same_dir : 7;
+	uint32_t ff_val; // ff_val / 3.0f - 1.0f, so 0 (-1.0f) means not flooded
+	uint16_t same_dir;
+	Direction dir;
 	uint8_t wall_exists : 1;
-	Direction dir : 7;
 	uint8_t visited : 1;
 };
 
@@ -24,25 +31,133 @@ struct PathNode {
 	}
 };
 
+// A floodfill's values, as kept in DiagonalSolver's flood members while it is the current floodfill.
+// The edges carry the walls too, which are only brought up to date for changed_edges when it is swapped in.
+struct DiagonalFloodState {
+	Grid<Edge> edges[2];
+	bool valid = false;
+	Point coord = Point(0, 0);
+	bool visited_edges_only = false;
+	std::vector<PathNode> changed_edges;
+	std::vector<PathNode> path;
+};
+
+// A floodfill result kept in the flood cache. Only the floodfill values of the edges are used.
+struct DiagonalFloodResult {
+	Grid<Edge> edges[2];
+	std::vector<PathNode> path;
+};
+
+// A fast run planner state waiting to be expanded, see PlanFastRun()
+struct FastRunEntry {
+	float time;
+	int state;
+};
+
+// How the planner reached a state: the straight from the edge of state parent (or from the starting cell for -1)
+// to the turn point, then the turn
+struct FastRunLink {
+	int parent;
+	int turn_x;
+	int turn_y;
+	MotionPrimitiveType turn; // PRIMITIVE_STRAIGHT for a straight that stops in the goal
+	bool right;
+};
+
+// Run waypoints (see RunCompiler) of a path of edges like DiagonalSolver's, from the middle of cell start
+void EdgePathWaypoints(const std::vector<PathNode>& path, Point start, std::vector<Waypoint>& dest);
+
 class DiagonalSolver : public Solver {
 private:
 	Point coord = Point(0, 0);
 	Maze* maze;
 
-	Edge edges[2][MAZE_ROWS + 1][MAZE_COLS + 1] = { 0 }; // edges[horizontal][row][column]
+	// Sized from the maze on Reset()
+	int rows = 0;
+	int cols = 0;
+	Grid<Edge> edges[2]; // edges[horizontal][row][column], each (rows + 1) x (cols + 1)
 	std::vector<PathNode> path;
+
+	// Paths of the finished run, see UpdateFinishedPaths()
+	std::vector<PathNode> solution_path;
+	std::vector<PathNode> alternative_path;
+	std::vector<PathNode> fast_path;
+	float solution_path_time = 0.0f;
+	float fast_path_time = 0.0f;
+	bool finished_paths_valid = false;
+	unsigned int finished_paths_maze_version = 0;
+
+	// Fast run planner scratch space, kept between plans. Planner states are an edge, the heading of the
+	// straight leaving it, and the speed limit it is left at (standing start, or after each turn).
+	std::vector<float> plan_times;
+	std::vector<FastRunLink> plan_links;
+	std::vector<FastRunEntry> plan_heap;
+	std::vector<int> plan_chain;
+	std::vector<Waypoint> plan_waypoints;
+	Grid<uint8_t> plan_goals;
+	RunCompiler run_compiler;
+	std::vector<MotionPrimitive> run_primitives;
+
+	// FindPath() scratch space, kept between searches
+	std::vector<uint32_t> search_costs;
+	std::vector<int> search_parents;
+	std::vector<uint64_t> search_heap;
+
 	bool finished;
 	bool going_back;
 	int run_number;
 
+	// Where the last floodfill started, and the edges newly visited since, so VerifyFloodfill() can redo it
+	bool flood_valid = false;
+	Point flood_coord = Point(0, 0);
+	bool flood_visited_edges_only = false;
+	std::vector<PathNode> changed_edges;
+	std::vector<PathNode> flood_queue;
+
+	// The floodfill from the starting cell that finds the start-to-goal path of the target updates. It is kept
+	// apart from the navigation floodfill, with its own copy of the edges that is brought up to date as walls
+	// are found. goal_flood_ready once its edges have been copied from the solver's.
+	DiagonalFloodState goal_flood;
+	bool goal_flood_ready = false;
+
+	// Zobrist hashes of the known walls (past the outer ones) and the visited edges, see FloodKey()
+	uint64_t walls_hash = 0;
+	uint64_t visited_hash = 0;
+	FloodCache<DiagonalFloodResult> flood_cache;
+
+	// Floodfill and path tracing code for the current maze size, see SelectSizedCode()
+	void (DiagonalSolver::*run_flood)(bool visited_edges_only) = nullptr;
+	void (DiagonalSolver::*trace_path)() = nullptr;
+
 	bool FindSurroundingWalls();
-	void Floodfill(bool visited_edges_only);
-	void UpdatePath();
-	void DrawPath(Color clr);
+	void Floodfill(bool visited_edges_only, FloodfillCause cause);
+	uint64_t FloodKey(bool visited_edges_only);
+	int EdgeIndex(bool horizontal, Point edge_coord);
 	void UpdateTargetCoords();
+	void UpdateGoalFlood();
+	void SwapFlood(DiagonalFloodState& state);
+	bool VerifyCurrentFlood();
+	void Resize(int rows, int cols);
+	void SelectSizedCode();
+
+	bool PlanMove(int* x, int* y, int heading, bool visited_edges_only);
+	int PlanState(int x, int y, int heading, int speed_slot);
+	int PlanPosition(int state, int* x, int* y);
+	void PlanStraights(int x, int y, int heading, int speed_slot, float time, int state, bool visited_edges_only);
+	void PlanRelax(int state, float time, const FastRunLink& link);
+
+	// Instantiated for the standard maze sizes, and for any size with ROWS = COLS = 0
+	template <int ROWS, int COLS> void UseSizedCode();
+	template <int ROWS, int COLS> void RunFlood(bool visited_edges_only);
+	template <int ROWS, int COLS> void StartFlood(bool visited_edges_only);
+	template <int ROWS, int COLS> void ContinueFlood();
+	template <int ROWS, int COLS> void TracePath();
+
+	friend class DiagonalSolverView;
 
 public:
 	std::vector<Point> target_coords;
+	MotionModel motion_model; // Time costs of the fast run
 
 	DiagonalSolver(Maze* maze, Point starting_coord);
 	~DiagonalSolver();
@@ -51,5 +166,37 @@ public:
 	void SoftReset() override;
 	void Step() override;
 	bool IsFinished() override;
-	void Draw(ray::Vector2 pos, bool show_floodfill_vals, Font floodfill_font) override;
+	bool VerifyFloodfill() override;
+
+	// Exposed for benchmarking; Step() calls these as needed
+	void Floodfill(bool visited_edges_only);
+	void UpdatePath();
+
+	// Once the run is finished, compute the solution path (through visited cells) and the alternative
+	// path (through any cell not known to be blocked), unless they are already computed for this run.
+	// Also plans the fast run through visited cells with PlanFastRun().
+	// Returns false if the run is not finished.
+	bool UpdateFinishedPaths() override;
+
+	void PathWaypoints(std::vector<Waypoint>& dest) override;
+	void SolutionWaypoints(std::vector<Waypoint>& dest) override;
+	void FastRunWaypoints(std::vector<Waypoint>& dest);
+
+	// Estimated time of the solution path and of the fast run, in seconds, once UpdateFinishedPaths() succeeds
+	float SolutionPathTime() const { return solution_path_time; }
+	float FastPathTime() const { return fast_path_time; }
+
+	// Plan the run from starting_coord to a goal that takes the least time under motion_model, rather than
+	// the fewest moves. Fills dest like path (last move first) and returns the estimated time in seconds,
+	// or -1 if no goal can be reached.
+	float PlanFastRun(bool visited_edges_only, std::vector<PathNode>& dest);
+
+	// Estimated time of a run along path (last move first) from the middle of cell start, under motion_model,
+	// once compiled into motion primitives. Returns -1 if the path doesn't compile.
+	float EstimateRunTime(const std::vector<PathNode>& path, Point start);
+
+	// A* search for the shortest path of edges from cell `from` to an edge of any of goals, with the floodfill's
+	// costs (3 across a cell, 2 diagonally), for single queries that don't need a whole floodfill.
+	// Fills dest like path (last edge first) and returns its cost, or -1 if no goal can be reached.
+	int FindPath(Point from, const std::vector<Point>& goals, bool visited_edges_only, std::vector<PathNode>& dest);
 };
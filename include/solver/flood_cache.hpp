@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Floodfill results kept per solver, and the largest mazes they are kept for (in cells), since every
+// entry holds a copy of the floodfill values
+#define FLOOD_CACHE_ENTRIES 8
+#define FLOOD_CACHE_MAX_CELLS (128 * 128)
+
+// What a Zobrist key stands for, so keys of different kinds of items never cancel out
+enum ZobristKind : uint8_t {
+	ZOBRIST_WALL = 0,     // A known wall, by wall or edge index
+	ZOBRIST_VISITED,      // A visited cell or edge
+	ZOBRIST_VISITED_ONLY, // Flooding visited cells or edges only
+	ZOBRIST_COORD,        // The solver's cell
+	ZOBRIST_TARGET        // A target, by its position in the list and its cell
+};
+
+// Fixed pseudo-random key of an item, for Zobrist hashes: the hash of a set of items is the XOR of their
+// keys, so adding or removing an item is a single XOR. Keys are mixed from the kind and index (SplitMix64)
+// rather than read from tables, so they need no storage for any maze size.
+inline uint64_t ZobristKey(ZobristKind kind, uint64_t index) {
+	uint64_t z = ((uint64_t)kind << 56 ^ index) + 0x9e3779b97f4a7c15ull;
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+// A bounded cache of floodfill results (Entry), keyed by a hash of everything the floodfill reads.
+// The least recently used entry is evicted first. Entries are reused in place, so once every entry
+// has been filled with a result of the maze's size, storing results doesn't allocate.
+template <typename Entry>
+class FloodCache {
+private:
+	struct Slot {
+		uint64_t key = 0;
+		unsigned long long last_used = 0; // 0 while empty
+		Entry entry;
+	};
+	std::vector<Slot> slots;
+	unsigned long long clock = 0;
+
+public:
+	FloodCache() : slots(FLOOD_CACHE_ENTRIES) { }
+
+	void Clear() {
+		for (Slot& slot : slots) {
+			slot.last_used = 0;
+		}
+	}
+
+	// The entry stored under key, or nullptr
+	Entry* Find(uint64_t key) {
+		for (Slot& slot : slots) {
+			if (slot.last_used != 0 && slot.key == key) {
+				slot.last_used = ++clock;
+				return &slot.entry;
+			}
+		}
+		return nullptr;
+	}
+
+	// The entry to store a result under key in, replacing the least recently used one
+	Entry& Insert(uint64_t key) {
+		Slot* oldest = &slots[0];
+		for (Slot& slot : slots) {
+			if (slot.last_used < oldest->last_used) {
+				oldest = &slot;
+			}
+		}
+		oldest->key = key;
+		oldest->last_used = ++clock;
+		return oldest->entry;
+	}
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "point.hpp"
+
+// Rows and columns of the maze being solved, for the floodfill and path tracing code.
+// Standard competition sizes get their own instantiations with ROWS and COLS set, where these are
+// compile-time constants, so loops and bounds checks fold away. MazeDims<0, 0> reads them at runtime.
+template <int ROWS, int COLS>
+struct MazeDims {
+	int runtime_rows;
+	int runtime_cols;
+
+	int Rows() const { return ROWS ? ROWS : runtime_rows; }
+	int Cols() const { return COLS ? COLS : runtime_cols; }
+
+	// Indices into row-major grids of cells (rows x cols), horizontal walls ((rows + 1) x cols),
+	// vertical walls (rows x (cols + 1)) and edges ((rows + 1) x (cols + 1))
+	int Cell(const Point& p) const { return p.y * Cols() + p.x; }
+	int HWall(const Point& p) const { return p.y * Cols() + p.x; }
+	int VWall(const Point& p) const { return p.y * (Cols() + 1) + p.x; }
+	int Edge(const Point& p) const { return p.y * (Cols() + 1) + p.x; }
+};
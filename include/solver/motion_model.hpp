@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Turns of a run, by how far they change the heading
+enum MotionTurn {
+	TURN_45 = 0,
+	TURN_90,
+	TURN_135,
+	TURN_180,
+	MOTION_TURN_COUNT
+};
+
+// Speed limits at the ends of a straight: one of the turns, or standing still
+#define MOTION_SPEED_STOP MOTION_TURN_COUNT
+#define MOTION_SPEED_COUNT (MOTION_TURN_COUNT + 1)
+
+#define SQRT_2 1.41421356f
+
+// What a robot executes: straights along the walls or on diagonals, and the standard smooth turns.
+// Turns that pass through cells (S90, S135 and S180) include the diagonal moves across them.
+enum MotionPrimitiveType : uint8_t {
+	PRIMITIVE_STRAIGHT = 0, // length half cells along the walls
+	PRIMITIVE_DIAGONAL,     // length diagonal moves, of half a cell diagonal each
+	PRIMITIVE_S45_IN,       // From along the walls onto a diagonal
+	PRIMITIVE_S45_OUT,      // From a diagonal back along the walls
+	PRIMITIVE_S90,          // Along the walls to along the walls, through one cell
+	PRIMITIVE_V90,          // Diagonal to diagonal, at a cell edge
+	PRIMITIVE_S135_IN,      // From along the walls onto a diagonal, through one cell
+	PRIMITIVE_S135_OUT,     // From a diagonal back along the walls, through one cell
+	PRIMITIVE_S180,         // U-turn through two cells
+	PRIMITIVE_TYPE_COUNT
+};
+
+const char* MotionPrimitiveName(MotionPrimitiveType type);
+
+struct MotionPrimitive {
+	MotionPrimitiveType type;
+	bool right; // Turns clockwise (turns only)
+	int length; // Straights only
+};
+
+struct TurnProfile {
+	float speed; // m/s, the fastest the turn can be taken
+	float time; // s, spent turning on top of the straight moves on either side
+};
+
+// What the mouse can do, in meters and seconds
+struct MotionProfile {
+	float cell_size;
+	float max_speed; // Along the walls
+	float max_diagonal_speed;
+	float acceleration;
+	float deceleration;
+	TurnProfile turns[MOTION_TURN_COUNT];
+};
+
+// A classic 18 cm maze mouse
+MotionProfile DefaultMotionProfile();
+
+// Overrides fields of profile from a list like "max_speed=3,turn90_speed=1.1". The fields are named as in
+// MotionProfile, with turn45_speed, turn45_time, ... turn180_time for the turns.
+// Returns 0 if a name or value is invalid.
+int ParseMotionProfile(const std::string& text, MotionProfile* profile);
+
+// Time costs of a run under a MotionProfile, for planning and comparing paths.
+// Straights are measured in units of half a cell along the walls, or of one diagonal move
+// (half a cell diagonal) on diagonals. The time of a straight with each pair of end speeds is
+// precomputed for every length up to where the mouse reaches top speed, so costs are lookups.
+class MotionModel {
+private:
+	MotionProfile profile;
+	float unit_length[2]; // m, [diagonal]
+	float top_speed[2]; // m/s, [diagonal]
+	float end_speeds[MOTION_SPEED_COUNT];
+	float turn_primitive_times[PRIMITIVE_TYPE_COUNT];
+
+	// straight_times[diagonal][(units * MOTION_SPEED_COUNT + entry_speed) * MOTION_SPEED_COUNT + exit_speed],
+	// for units below table_length[diagonal]
+	std::vector<float> straight_times[2];
+	int table_length[2];
+
+	void BuildTables();
+
+public:
+	MotionModel();
+	MotionModel(const MotionProfile& profile);
+
+	void SetProfile(const MotionProfile& profile);
+	const MotionProfile& Profile() const { return profile; }
+
+	// Time to cover units with a trapezoidal speed profile, from a speed limit of entry_speed to one of
+	// exit_speed (a MotionTurn, or MOTION_SPEED_STOP)
+	float StraightTime(bool diagonal, int units, int entry_speed, int exit_speed) const {
+		if (units < table_length[diagonal]) {
+			return straight_times[diagonal][(units * MOTION_SPEED_COUNT + entry_speed) * MOTION_SPEED_COUNT + exit_speed];
+		}
+
+		// Past the table the extra distance is all covered at top speed
+		int last = table_length[diagonal] - 1;
+		return straight_times[diagonal][(last * MOTION_SPEED_COUNT + entry_speed) * MOTION_SPEED_COUNT + exit_speed]
+			+ (units - last) * unit_length[diagonal] / top_speed[diagonal];
+	}
+
+	float TurnTime(MotionTurn turn) const { return profile.turns[turn].time; }
+
+	// The turn of a turn primitive, or -1 for straights
+	static int PrimitiveTurn(MotionPrimitiveType type);
+
+	// Time of a turn primitive, crossing its cells at the turn speed
+	float TurnPrimitiveTime(MotionPrimitiveType type) const { return turn_primitive_times[type]; }
+
+	// Time to drive a compiled run (see RunCompiler) from a standing start to a stop, with every straight
+	// driven with a trapezoidal speed profile between the speed limits of the turns on either side
+	float RunTime(const std::vector<MotionPrimitive>& run) const;
+
+	// Time to cover distance from speed v0 to speed v1, without going over v_max
+	static float TrapezoidTime(float distance, float v0, float v1, float v_max, float acceleration, float deceleration);
+};
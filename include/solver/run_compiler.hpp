@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+
+#include "point.hpp"
+#include "solver/motion_model.hpp"
+
+// A point of a run, in half cells: the middle of cell (x, y) is at (2x + 1, 2y + 1),
+// and the middles of its top and left sides at (2x + 1, 2y) and (2x, 2y + 1)
+struct Waypoint {
+	int x;
+	int y;
+};
+
+// Turns paths into the motion primitives a robot executes (see MotionPrimitiveType).
+// A path is given as waypoints from the middle of the starting cell through the middle of every cell side
+// it crosses, so moves are half a cell out of the starting cell, a cell along the walls, or half a cell
+// diagonal between neighboring sides of a cell. Paths through cell middles (like the simple solver's)
+// become diagonals wherever they zigzag.
+// Scratch space is kept between runs, so compiling many paths doesn't allocate.
+class RunCompiler {
+private:
+	// Moves grouped by heading (0 to 7, clockwise from up)
+	struct Stretch {
+		int heading;
+		int moves;
+		int units; // Half cells along the walls, or diagonal moves
+	};
+	std::vector<Stretch> stretches;
+
+	void AddStraight(const Stretch& stretch, std::vector<MotionPrimitive>& dest);
+	int MatchTurn(int stretch, std::vector<MotionPrimitive>& dest);
+
+public:
+	// Fills dest with the run along waypoints. Returns 0 if two waypoints aren't one move apart.
+	int Compile(const std::vector<Waypoint>& waypoints, std::vector<MotionPrimitive>& dest);
+};
+
+// Run waypoints of a path of cells (after the starting cell), such as the simple solver's, through the middle
+// of every cell side crossed. path is ordered like the solvers' paths, last cell first.
+void CellPathWaypoints(const std::vector<Point>& path, Point start, std::vector<Waypoint>& dest);
@@ -1,34 +1,124 @@
 #pragma once
 
+#include "grid.hpp"
 #include "solver.hpp"
+#include "ring_queue.hpp"
+#include "solver/flood_cache.hpp"
 
-#define SIMPLE_FF_UNSET UINT16_MAX
+#define SIMPLE_FF_UNSET UINT32_MAX
+
+// The bitboard backend stores each maze row in a uint16_t, so wider mazes use the queue
+#define SIMPLE_BITBOARD_MAX_COLS 16
+
+enum SimpleFloodfillBackend : uint8_t {
+	SIMPLE_FF_QUEUE,    // Breadth-first search through a queue, one cell at a time
+	SIMPLE_FF_BITBOARD, // Bit-parallel wavefront over wall bitboards, one distance at a time (narrow mazes only)
+};
+
+// A floodfill's values, as kept in SimpleSolver's ff members while it is the current floodfill
+struct SimpleFloodState {
+	Grid<uint32_t> vals;
+	bool valid = false;
+	bool visited_cells_only = false;
+	std::vector<Point> targets;
+	std::vector<Point> changed_cells;
+	std::vector<Point> path;
+};
+
+// A floodfill result kept in the flood cache
+struct SimpleFloodResult {
+	Grid<uint32_t> vals;
+	std::vector<Point> path;
+};
 
 class SimpleSolver : public Solver {
 private:
 	Point coord;
 	Maze* maze;
 
-	bool known_h_walls[MAZE_ROWS + 1][MAZE_COLS] = {};
-	bool known_v_walls[MAZE_ROWS][MAZE_COLS + 1] = {};
-	bool h_wall_seen[MAZE_ROWS + 1][MAZE_COLS] = {};
-	bool v_wall_seen[MAZE_ROWS][MAZE_COLS + 1] = {};
-	bool cell_visited[MAZE_ROWS][MAZE_COLS] = {};
-	uint16_t ff_vals[MAZE_ROWS][MAZE_COLS] = {};
+	// Sized from the maze on Reset()
+	int rows = 0;
+	int cols = 0;
+	Grid<bool> known_h_walls; // (rows + 1) x cols
+	Grid<bool> known_v_walls; // rows x (cols + 1)
+	Grid<bool> h_wall_seen;
+	Grid<bool> v_wall_seen;
+	Grid<bool> cell_visited;
+	Grid<uint32_t> ff_vals;
+	RingQueue<Point> ff_queue; // Every cell is pushed at most once
+
+	// Bitboards of the known maze, one uint16_t per row with bit c standing for column c.
+	// Only kept up to date when the maze is at most SIMPLE_BITBOARD_MAX_COLS wide.
+	std::vector<uint16_t> h_open_bits; // No known wall between row r - 1 and row r
+	std::vector<uint16_t> v_open_bits; // No known wall between column c - 1 and column c
+	std::vector<uint16_t> visited_bits;
+	std::vector<uint16_t> wavefront_bits; // Scratch rows for BitboardFloodfill()
 
 	std::vector<Point> path;
+
+	// Paths of the finished run, see UpdateFinishedPaths()
+	std::vector<Point> solution_path;
+	std::vector<Point> alternative_path;
+	bool finished_paths_valid = false;
+	unsigned int finished_paths_maze_version = 0;
+
 	bool finished = false;
 	bool going_back = false;
 	int run_number = 0;
 
+	// What the current ff_vals were flooded from, so they can be repaired instead of recomputed
+	bool ff_valid = false;
+	bool ff_visited_cells_only = false;
+	std::vector<Point> ff_targets;
+	std::vector<Point> changed_cells; // Cells next to walls discovered since the last floodfill
+	std::vector<Point> raised_cells;
+	std::vector<uint64_t> repair_heap;
+
+	// The floodfill from the goals that finds the start-to-goal path of the target updates. It is kept
+	// between updates and repaired like the navigation floodfill, instead of flooding from scratch every time.
+	SimpleFloodState goal_flood;
+
+	// Zobrist hashes of the known walls (past the outer ones) and the visited cells, see FloodKey()
+	uint64_t walls_hash = 0;
+	uint64_t visited_hash = 0;
+	FloodCache<SimpleFloodResult> flood_cache;
+
+	// FindPath() scratch space, kept between searches
+	std::vector<uint32_t> search_costs;
+	std::vector<int> search_parents;
+	std::vector<uint64_t> search_heap;
+
+	// Floodfill and path tracing code for the current maze size, see SelectSizedCode()
+	void (SimpleSolver::*queue_floodfill)(bool visited_cells_only) = nullptr;
+	void (SimpleSolver::*bitboard_floodfill)(bool visited_cells_only) = nullptr;
+	void (SimpleSolver::*repair_floodfill)() = nullptr;
+	void (SimpleSolver::*trace_path)() = nullptr;
+
 	bool FindSurroundingWalls();
-	void Floodfill(bool visited_cells_only);
-	void UpdatePath();
+	void Floodfill(bool visited_cells_only, FloodfillCause cause);
+	void FullFloodfill(bool visited_cells_only);
+	uint64_t FloodKey(bool visited_cells_only);
 	void UpdateTargetCoords();
-	void DrawPath(Color clr);
+	void UpdateGoalFlood();
+	void SwapFlood(SimpleFloodState& state);
+	bool VerifyCurrentFlood();
+	bool UsesBitboards();
+	void Resize(int rows, int cols);
+	void SelectSizedCode();
+
+	// Instantiated for the standard maze sizes, and for any size with ROWS = COLS = 0
+	template <int ROWS, int COLS> void UseSizedCode();
+	template <int ROWS, int COLS> int OpenNeighbors(Point p, Point neighbors[4]);
+	template <int ROWS, int COLS> void QueueFloodfill(bool visited_cells_only);
+	template <int ROWS, int COLS> void BitboardFloodfill(bool visited_cells_only);
+	template <int ROWS, int COLS> void RepairFloodfill();
+	template <int ROWS, int COLS> void TracePath();
+
+	friend class SimpleSolverView;
 
 public:
 	std::vector<Point> target_coords;
+	SimpleFloodfillBackend floodfill_backend = SIMPLE_FF_QUEUE; // Used for full floodfills
 
 	SimpleSolver(Maze* maze, Point starting_coord);
 	~SimpleSolver();
@@ -37,5 +127,22 @@ public:
 	void SoftReset() override;
 	void Step() override;
 	bool IsFinished() override;
-	void Draw(ray::Vector2 pos, bool show_floodfill_vals, Font floodfill_font) override;
+	bool VerifyFloodfill() override;
+
+	// Exposed for benchmarking; Step() calls these as needed
+	void Floodfill(bool visited_cells_only);
+	void UpdatePath();
+
+	// Once the run is finished, compute the solution path (through visited cells) and the alternative
+	// path (through any cell not known to be blocked), unless they are already computed for this run.
+	// Returns false if the run is not finished.
+	bool UpdateFinishedPaths() override;
+
+	// A* search for the shortest path from `from` to any of goals over the known walls, for single queries
+	// that don't need a whole floodfill. Fills dest like path (next step last) and returns its length in cells,
+	// or -1 if no goal can be reached.
+	int FindPath(Point from, const std::vector<Point>& goals, bool visited_cells_only, std::vector<Point>& dest);
+
+	void PathWaypoints(std::vector<Waypoint>& dest) override;
+	void SolutionWaypoints(std::vector<Waypoint>& dest) override;
 };
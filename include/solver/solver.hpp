@@ -2,15 +2,34 @@
 
 #include "maze.hpp"
 #include "point.hpp"
+#include "solver/run_compiler.hpp"
+#include "solver/solver_stats.hpp"
 
 class Solver {
 public:
 	Point starting_coord = Point(0, 0);
+	int floodfill_count = 0; // Number of floodfills since the last Reset()
+	unsigned int known_walls_version = 0; // Changes whenever walls are discovered, or forgotten by Reset()
+	unsigned int floodfill_version = 0; // Changes whenever the floodfill values are recomputed
+	bool incremental_floodfill = true; // Repair the previous floodfill values when only new walls were found
+	bool cache_floodfills = false; // Reuse earlier floodfills of the same known walls and targets (see FloodCache)
+	bool astar_target_paths = false; // Find the start-to-goal path of the target updates with A* instead of a floodfill
+	SolverStats stats; // Counters of the current run
+
+	// Returns true if the current floodfill values match a full floodfill
+	virtual bool VerifyFloodfill() = 0;
 
 	virtual ~Solver() = default;
 	virtual void Reset() = 0;
 	virtual void SoftReset() = 0;
 	virtual void Step() = 0;
 	virtual bool IsFinished() = 0;
-	virtual void Draw(ray::Vector2 pos, bool show_floodfill_vals, Font floodfill_font) = 0;
+
+	// Once the run is finished, compute the paths of the finished run. Returns false if the run is not finished.
+	virtual bool UpdateFinishedPaths() = 0;
+
+	// Run waypoints (see RunCompiler) of the current path from the current cell, and of the solution path
+	// from the starting cell once UpdateFinishedPaths() succeeds
+	virtual void PathWaypoints(std::vector<Waypoint>& dest) = 0;
+	virtual void SolutionWaypoints(std::vector<Waypoint>& dest) = 0;
 };
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Why a floodfill was run
+enum FloodfillCause : uint8_t {
+	FLOODFILL_OTHER = 0,     // Called from outside the run, like the finished paths or benchmarks
+	FLOODFILL_RUN_START,     // Start of a run
+	FLOODFILL_NEW_WALLS,     // Walls were discovered
+	FLOODFILL_TARGET_CHANGE, // A target was reached, or the targets were recomputed
+	FLOODFILL_CAUSE_COUNT
+};
+
+const char* FloodfillCauseName(FloodfillCause cause);
+
+// What a run cost. Cleared when a run starts, by Reset() or SoftReset().
+struct SolverStats {
+	long long steps = 0;
+	long long step_ns = 0; // Total time spent in Step()
+	long long max_step_ns = 0;
+	long long floodfills[FLOODFILL_CAUSE_COUNT] = { 0 };
+	long long incremental_floodfills = 0; // Floodfills that repaired or resumed the previous values
+	long long queue_pushes = 0;
+	long long queue_pops = 0;
+	long long expansions = 0; // Cells (simple solver) or edges (diagonal solver) whose neighbors were examined
+	long long path_updates = 0;
+	long long path_length_total = 0;
+	long long max_path_length = 0;
+	long long target_updates = 0; // UpdateTargetCoords() calls
+	long long path_searches = 0; // FindPath() calls
+	long long search_expansions = 0; // Cells or edges FindPath() expanded
+	long long flood_cache_hits = 0; // Floodfills answered from the flood cache
+	long long flood_cache_misses = 0;
+
+	long long TotalFloodfills() const;
+	double FloodCacheHitRate() const; // 0 to 1, or 0 without cache lookups
+
+	// Count a path traced for a floodfill
+	void AddPath(size_t length) {
+		path_updates++;
+		path_length_total += length;
+		if ((long long)length > max_path_length) {
+			max_path_length = length;
+		}
+	}
+};
+
+// Export as a CSV row (without a line break), with the columns of SolverStatsCsvHeader()
+std::string SolverStatsCsvHeader();
+std::string SolverStatsToCsv(const SolverStats& stats);
+
+// Export as a JSON object
+std::string SolverStatsToJson(const SolverStats& stats);
+
+// Adds the time until it goes out of scope to the step counters
+class StepTimer {
+private:
+	SolverStats& stats;
+	std::chrono::steady_clock::time_point start;
+
+public:
+	StepTimer(SolverStats& stats) : stats(stats), start(std::chrono::steady_clock::now()) { }
+	~StepTimer() {
+		long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+		stats.steps++;
+		stats.step_ns += ns;
+		if (ns > stats.max_step_ns) {
+			stats.max_step_ns = ns;
+		}
+	}
+};
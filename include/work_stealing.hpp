@@ -0,0 +1,12 @@
+#pragma once
+
+#include <functional>
+
+// Runs task(index, worker) for every index in [0, count) on up to thread_count threads (worker is
+// in [0, thread_count)), and returns once all of them are done. The calling thread is worker 0.
+// Each worker starts with an even share of the indices, in order. A worker that runs out steals the
+// back half of another worker's remaining indices, so tasks of uneven length still keep all threads busy.
+void ParallelFor(int count, int thread_count, const std::function<void(int index, int worker)>& task);
+
+// Number of threads the hardware can run at once, at least 1
+int DefaultThreadCount();
@@ -12,17 +12,20 @@ ray::Vector2 scroll = ray::Vector2(0.0f, 0.0f);
 ray::Rectangle content_rec = ray::Rectangle(0.0f, 0.0f, 0.0f, 10.0f);
 bool recent_error = false;
 
-void ConsoleLog(std::string msg) {
+void ConsoleLog(const std::string& msg) {
 	logs.push_back(msg);
 	std::cout << msg << std::endl;
 	recent_error = false;
 
-	// Adjust content_rec size to accomodate the message
-	content_rec.width = std::max(content_rec.width, (float)GuiGetTextWidth(msg.c_str())) + 10.0f;
+	// Adjust content_rec size to accomodate the message.
+	// Text can only be measured once a window (and its default font) exists.
+	if (IsWindowReady()) {
+		content_rec.width = std::max(content_rec.width, (float)GuiGetTextWidth(msg.c_str())) + 10.0f;
+	}
 	content_rec.height += LINE_HEIGHT;
 }
 
-void ConsoleError(std::string msg) {
+void ConsoleError(const std::string& msg) {
 	ConsoleLog(msg);
 	recent_error = true;
 }
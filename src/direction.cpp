@@ -1,5 +1,5 @@
 #include "direction.hpp"
-#include "console.hpp"
+#include "log.hpp"
 
 Direction NormalizeDir(Direction dir) {
 	switch (dir) {
@@ -20,7 +20,7 @@ Direction NormalizeDir(Direction dir) {
 	case DIR_DOWN_RIGHT:
 		return DIR_RIGHT;
 	default:
-		ConsoleError("Direction is Invalid!");
+		LogError("Direction is Invalid!");
 		return DIR_UNKNOWN;
 	}
 }
@@ -52,7 +52,7 @@ Direction ReverseDir(Direction dir) {
 	case DIR_DOWN_RIGHT:
 		return DIR_LEFT_UP;
 	default:
-		ConsoleError("Direction is Invalid!");
+		LogError("Direction is Invalid!");
 		return DIR_UNKNOWN;
 	}
 }
@@ -84,7 +84,7 @@ Direction ComplementDir(Direction dir) {
 	case DIR_DOWN_RIGHT:
 		return DIR_RIGHT_DOWN;
 	default:
-		ConsoleError("Direction is Invalid!");
+		LogError("Direction is Invalid!");
 		return DIR_UNKNOWN;
 	}
 }
@@ -132,7 +132,7 @@ void GetNextPossibleEdges(bool dest_horizontals[3], Point dest_edges[3], Directi
 		dest_edges[2] = Point(0, 1); // DIR_RIGHT_DOWN
 		break;
 	default:
-		ConsoleError("Direction is not normalized!");
+		LogError("Direction is not normalized!");
 		break;
 	}
 }
@@ -158,7 +158,7 @@ Point DirToCell(Point coord, Direction dir) {
 	case DIR_RIGHT:
 		return coord;
 	default:
-		ConsoleError("Direction is Invalid!");
+		LogError("Direction is Invalid!");
 		return coord;
 	}
 }
@@ -190,7 +190,7 @@ std::string DirToStr(Direction dir) {
 	case DIR_DOWN_RIGHT:
 		return "DR";
 	default:
-		ConsoleError("Direction is Invalid!");
+		LogError("Direction is Invalid!");
 		return "_";
 	}
 }
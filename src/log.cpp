@@ -0,0 +1,27 @@
+#include <iostream>
+
+#include "log.hpp"
+
+void PrintLog(const std::string& msg) {
+	std::cout << msg << std::endl;
+}
+
+LogHandler info_log_handler = PrintLog;
+LogHandler error_log_handler = PrintLog;
+
+void SetLogHandlers(LogHandler info_handler, LogHandler error_handler) {
+	info_log_handler = info_handler;
+	error_log_handler = error_handler;
+}
+
+void LogInfo(const std::string& msg) {
+	if (info_log_handler) {
+		info_log_handler(msg);
+	}
+}
+
+void LogError(const std::string& msg) {
+	if (error_log_handler) {
+		error_log_handler(msg);
+	}
+}
@@ -1,4 +1,8 @@
+#include <atomic>
+#include <cmath>
+#include <fstream>
 #include <iostream>
+#include <thread>
 #include <raylib.h>
 #include <raylib-cpp.hpp>
 
@@ -9,14 +13,29 @@
 #include "point.hpp"
 #include "maze.hpp"
 #include "console.hpp"
+#include "log.hpp"
 #include "solver/diagonal_solver.hpp"
 #include "solver/simple_solver.hpp"
+#include "render/maze_view.hpp"
+#include "render/diagonal_solver_view.hpp"
+#include "render/simple_solver_view.hpp"
 
 namespace ray = raylib;
 
 #define SCREEN_WIDTH 1200
 #define SCREEN_HEIGHT 1000
 
+// Range of the solver speed slider, as log10 of the steps per second (1 to 10000 steps per second)
+#define MIN_SOLVER_SPEED 0.0f
+#define MAX_SOLVER_SPEED 4.0f
+
+// Seconds a frame may spend stepping the solver. When steps take longer than the speed allows,
+// the solver runs slower instead of holding up the rendering.
+#define MAX_STEP_TIME_PER_FRAME 0.010
+
+// Most steps SKIP ANIMATION runs before giving up on a solver that doesn't finish
+#define SKIP_STEP_BUDGET 1000000
+
 enum ApplicationState {
 	IDLE,
 	PLACING_WALL,
@@ -35,17 +54,31 @@ Point edit_wall_from = Point(0, 0);
 bool maze_is_editable = false;
 bool show_floodfill_vals = false;
 bool show_full_map = true;
-float solver_step_interval = 0.80f;
-float step_timer = 0.0f;
+float solver_speed = 0.7f; // log10 of the steps per second
+double step_accumulator = 0.0; // Seconds of solving not yet turned into steps
+
+// SKIP ANIMATION runs the solver to the end on a worker thread.
+// While skipping, only the worker touches the solver, so it isn't drawn and the controls are locked.
+bool skipping = false;
+std::thread skip_worker;
+std::atomic<int> skip_steps(0);
+std::atomic<bool> skip_cancelled(false);
+std::atomic<bool> skip_done(false);
 Font roboto;
 
 // Core entities
-Maze maze = Maze(ray::Vector2(100.0f, 80.0f));
+Maze maze = Maze();
 DiagonalSolver diagonal_solver = DiagonalSolver(&maze, Point(0, 0));
 SimpleSolver   simple_solver   = SimpleSolver(&maze, Point(0, 0));
 Solver* solver = &diagonal_solver;
 bool use_diagonal_solver = true;
 
+// Rendering of the core entities
+MazeView maze_view = MazeView(&maze, ray::Vector2(100.0f, 80.0f));
+DiagonalSolverView diagonal_solver_view = DiagonalSolverView(&diagonal_solver, &maze_view);
+SimpleSolverView   simple_solver_view   = SimpleSolverView(&simple_solver, &maze_view);
+SolverView* solver_view = &diagonal_solver_view;
+
 // UI layout
 ray::Vector2 ui_anchor = ray::Vector2(SCREEN_WIDTH - 300.0f, 0.0f);
 ray::Vector2 console_anchor = ray::Vector2(0.0f, SCREEN_HEIGHT - 150.0f);
@@ -59,22 +92,24 @@ ray::Rectangle ui_layout_recs[] = {
 	ray::Rectangle(ui_anchor.x + 10.0f, ui_anchor.y + 490.0f + 60.0f, 280.0f, 50.0f), // Stop Solver
 	ray::Rectangle(ui_anchor.x + 10.0f, ui_anchor.y + 260.0f + 60.0f, 30.0f, 30.0f), // Show FloodFill Values
 	ray::Rectangle(ui_anchor.x + 10.0f, ui_anchor.y + 320.0f + 60.0f, 30.0f, 30.0f), // Show Full Map
-	ray::Rectangle(ui_anchor.x + 70.0f, ui_anchor.y + 380.0f + 60.0f, 160.0f, 30.0f), // Solver Speed Slider
+	ray::Rectangle(ui_anchor.x + 70.0f, ui_anchor.y + 380.0f + 60.0f, 140.0f, 30.0f), // Solver Speed Slider
 	ray::Rectangle(ui_anchor.x + 10.0f, ui_anchor.y + 430.0f + 60.0f, 280.0f, 50.0f), // Skip Animation
 	ray::Rectangle(console_anchor.x, console_anchor.y, 900.0f, 150.0f), // Console
 	ray::Rectangle(console_anchor.x + 820.0f, console_anchor.y + 2.0f, 70.0f, 20.0f), // Clear Console
-	ray::Rectangle(ui_anchor.x + 10.0f, ui_anchor.y + 190.0f, 280.0f, 50.0f) // Solver Type Toggle
+	ray::Rectangle(ui_anchor.x + 10.0f, ui_anchor.y + 190.0f, 280.0f, 50.0f), // Solver Type Toggle
+	ray::Rectangle(ui_anchor.x + 10.0f, ui_anchor.y + 610.0f, 200.0f, 30.0f), // Skip Status
+	ray::Rectangle(ui_anchor.x + 10.0f, ui_anchor.y + 660.0f, 280.0f, 50.0f) // Export Stats
 };
 GuiWindowFileDialogState file_dialog_state;
 
 void PreUpdate() {
-	closest_corner_to_mouse = maze.ClosestCornerTo(GetMousePosition());
+	closest_corner_to_mouse = maze_view.ClosestCornerTo(GetMousePosition());
 }
 
 void PostUpdate() {
 	// Pan the view
 	if (IsMouseButtonDown(MOUSE_BUTTON_MIDDLE)) {
-		maze.position += GetMouseDelta();
+		maze_view.position += GetMouseDelta();
 	}
 }
 
@@ -83,13 +118,13 @@ void Idle_Update() {
 
 	if (m.x < ui_anchor.x) {
 		Point mouse_coord = Point(
-			(m.x - maze.position.x) / MAZE_CELL_SIZE,
-			(m.y - maze.position.y) / MAZE_CELL_SIZE
+			(m.x - maze_view.position.x) / maze_view.CellSize(),
+			(m.y - maze_view.position.y) / maze_view.CellSize()
 		);
 
 		if (maze_is_editable) {
 			// Controls for adding/deleting Walls
-			if (maze.Contains(m)) {
+			if (maze_view.Contains(m)) {
 				if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
 					edit_wall_from = closest_corner_to_mouse;
 					state = PLACING_WALL;
@@ -109,7 +144,7 @@ void Idle_Update() {
 }
 
 void PlacingWall_Update() {
-	if (maze.Contains(GetMousePosition()) && IsMouseButtonReleased(MOUSE_BUTTON_LEFT)) {
+	if (maze_view.Contains(GetMousePosition()) && IsMouseButtonReleased(MOUSE_BUTTON_LEFT)) {
 		maze.SetWalls(edit_wall_from, closest_corner_to_mouse, true);
 		state = IDLE;
 		return;
@@ -117,7 +152,7 @@ void PlacingWall_Update() {
 }
 
 void DeletingWall_Update() {
-	if (maze.Contains(GetMousePosition()) && IsMouseButtonReleased(MOUSE_BUTTON_RIGHT)) {
+	if (maze_view.Contains(GetMousePosition()) && IsMouseButtonReleased(MOUSE_BUTTON_RIGHT)) {
 		maze.SetWalls(edit_wall_from, closest_corner_to_mouse, false);
 		state = IDLE;
 		return;
@@ -126,15 +161,33 @@ void DeletingWall_Update() {
 
 void MovingStartingCoord_Update() {
 	ray::Vector2 m = GetMousePosition();
-	if (m.x < ui_anchor.x && maze.Contains(m) && IsMouseButtonReleased(MOUSE_BUTTON_LEFT)) {
+	if (m.x < ui_anchor.x && maze_view.Contains(m) && IsMouseButtonReleased(MOUSE_BUTTON_LEFT)) {
 		solver->starting_coord = Point(
-			(m.x - maze.position.x) / MAZE_CELL_SIZE,
-			(m.y - maze.position.y) / MAZE_CELL_SIZE
+			(m.x - maze_view.position.x) / maze_view.CellSize(),
+			(m.y - maze_view.position.y) / maze_view.CellSize()
 		);
 		state = IDLE;
 	}
 }
 
+// Writes the counters of the current run next to the maze file as <name>_stats.json
+void ExportStats() {
+	std::string filename = maze_filename.empty() ? std::string("maze") : maze_filename;
+	size_t dot = filename.rfind('.');
+	if (dot != std::string::npos && filename.find_first_of("/\\", dot) == std::string::npos) {
+		filename.erase(dot);
+	}
+	filename += "_stats.json";
+
+	std::ofstream file(filename);
+	file << SolverStatsToJson(solver->stats) << "\n";
+	if (!file) {
+		ConsoleError("Unable to write stats: " + filename);
+		return;
+	}
+	ConsoleLog("Saved solver stats: " + filename);
+}
+
 void FileDialogLogic() {
 	// When a file is selected from the built-in file browser
 	if (file_dialog_state.SelectFilePressed) {
@@ -173,10 +226,57 @@ void FileDialogLogic() {
 	}
 }
 
+void StartSkipping() {
+	skipping = true;
+	skip_steps = 0;
+	skip_cancelled = false;
+	skip_done = false;
+
+	Solver* skipped_solver = solver;
+	skip_worker = std::thread([skipped_solver]() {
+		int steps = 0;
+		while (!skipped_solver->IsFinished() && steps < SKIP_STEP_BUDGET && !skip_cancelled) {
+			skipped_solver->Step();
+			skip_steps = ++steps;
+		}
+		skip_done = true;
+	});
+}
+
+// Wait for the skip worker to stop, after which the solver belongs to this thread again
+void StopSkipping() {
+	skip_worker.join();
+	skipping = false;
+	step_accumulator = 0.0;
+}
+
+// Run as many steps as the solver speed asks for in the time since the last frame.
+// The solver is only drawn between frames, so it is always drawn between whole steps.
 void SolvingMaze_Update() {
-	if (!solver->IsFinished() && (step_timer -= GetFrameTime()) <= 0.0f) {
-		step_timer = 1.0f - solver_step_interval;
+	if (skipping) {
+		if (skip_done) {
+			StopSkipping();
+			if (!solver->IsFinished() && !skip_cancelled) {
+				ConsoleError("Solver did not finish within " + std::to_string(SKIP_STEP_BUDGET) + " steps");
+			}
+		}
+		return;
+	}
+	if (solver->IsFinished()) {
+		return;
+	}
+
+	double step_period = 1.0 / pow(10.0, solver_speed);
+	double start = GetTime();
+	step_accumulator += GetFrameTime();
+	while (step_accumulator >= step_period && !solver->IsFinished()) {
 		solver->Step();
+		step_accumulator -= step_period;
+
+		if (GetTime() - start > MAX_STEP_TIME_PER_FRAME) {
+			step_accumulator = 0.0;
+			break;
+		}
 	}
 }
 
@@ -189,6 +289,9 @@ void DrawUI() {
 
 	// UI controls on the right side
 	GuiPanel(ui_layout_recs[0], "Micromouse Simulator");
+	if (skipping) {
+		GuiLock();
+	}
 	if (GuiButton(ui_layout_recs[1], "LOAD MAZE LAYOUT")) {
 		file_dialog_state.windowActive = true;
 		state = LOADING_MAZE;
@@ -214,7 +317,7 @@ void DrawUI() {
 		} else {
 			solver->Reset();
 			maze_is_editable = false;
-			step_timer = 0.5f;
+			step_accumulator = -0.5; // Short pause before the first step
 			state = SOLVING_MAZE;
 		}
 	}
@@ -222,6 +325,7 @@ void DrawUI() {
 		Point start_coord = solver->starting_coord;
 		use_diagonal_solver = !use_diagonal_solver;
 		solver = use_diagonal_solver ? (Solver*)&diagonal_solver : (Solver*)&simple_solver;
+		solver_view = use_diagonal_solver ? (SolverView*)&diagonal_solver_view : (SolverView*)&simple_solver_view;
 		solver->starting_coord = start_coord;
 	}
 	GuiSetState(STATE_NORMAL);
@@ -231,13 +335,30 @@ void DrawUI() {
 		}
 		GuiCheckBox(ui_layout_recs[7], "Show FloodFill Values", &show_floodfill_vals);
 		GuiCheckBox(ui_layout_recs[8], "Show Full Map", &show_full_map);
-		GuiSlider(ui_layout_recs[9], "SLOW", "FAST", &solver_step_interval, 0.1f, 1.0f);
-		if (GuiButton(ui_layout_recs[10], "SKIP ANIMATION")) {
-			while (!solver->IsFinished()) {
-				solver->Step();
+		GuiSlider(
+			ui_layout_recs[9],
+			"SLOW",
+			TextFormat("%.0f/s", pow(10.0, solver_speed)),
+			&solver_speed,
+			MIN_SOLVER_SPEED,
+			MAX_SOLVER_SPEED
+		);
+		if (GuiButton(ui_layout_recs[15], "EXPORT STATS")) {
+			ExportStats();
+		}
+		GuiUnlock();
+		if (skipping) {
+			// How long a run takes isn't known up front, so show the steps so far rather than a fraction
+			// of SKIP_STEP_BUDGET, which a normal run would barely start filling
+			GuiStatusBar(ui_layout_recs[14], TextFormat("Skipping... %d steps", (int)skip_steps));
+			if (GuiButton(ui_layout_recs[10], "CANCEL SKIP")) {
+				skip_cancelled = true;
 			}
+		} else if (GuiButton(ui_layout_recs[10], "SKIP ANIMATION") && !solver->IsFinished()) {
+			StartSkipping();
 		}
 	}
+	GuiUnlock();
 	ConsoleDraw(ui_layout_recs[11]);
 	if (GuiButton(ui_layout_recs[12], "clear")) {
 		ConsoleClear();
@@ -251,6 +372,7 @@ int main(int argc, char** argv) {
 	ray::Window window = ray::Window(SCREEN_WIDTH, SCREEN_HEIGHT, "Micromouse");
 	window.SetTargetFPS(60);
 	GuiSetStyle(DEFAULT, TEXT_SIZE, 20);
+	SetLogHandlers(ConsoleLog, ConsoleError);
 
 	// Maze file name can be put in as a command line argument
 	if (argc == 1) {
@@ -309,8 +431,8 @@ int main(int argc, char** argv) {
 		// Color the target area green
 		for (Point goal : maze.goals) {
 			DrawRectangleV(
-				maze.CornerToPos(goal),
-				ray::Vector2(MAZE_CELL_SIZE, MAZE_CELL_SIZE),
+				maze_view.CornerToPos(goal),
+				ray::Vector2(maze_view.CellSize(), maze_view.CellSize()),
 				ColorAlpha(GREEN, 0.5f)
 			);
 		}
@@ -320,25 +442,25 @@ int main(int argc, char** argv) {
 		if (state == SOLVING_MAZE) {
 			wall_clr = show_full_map ? LIGHTGRAY : ColorAlpha(BLACK, 0.0f);
 		}
-		maze.Draw(wall_clr, RED);
+		maze_view.Draw(wall_clr, RED);
 
 		if (maze_is_editable) {
-			Vector2 closest_corner_pos = maze.CornerToPos(closest_corner_to_mouse);
-			Vector2 edit_wall_pos = maze.CornerToPos(edit_wall_from);
+			Vector2 closest_corner_pos = maze_view.CornerToPos(closest_corner_to_mouse);
+			Vector2 edit_wall_pos = maze_view.CornerToPos(edit_wall_from);
 
 			// Show which corner is affected by the mouse while editing
-			if (maze.Contains(GetMousePosition())) {
+			if (maze_view.Contains(GetMousePosition())) {
 				DrawCircleLinesV(closest_corner_pos, 6.0f, BLACK);
 			}
 
 			// Draw the walls that are about to be edited by the user in green.
 			// If the action is invalid, draw the line in red.
 			if (state == PLACING_WALL || state == DELETING_WALL) {
-				if (maze.Contains(GetMousePosition())) {
+				if (maze_view.Contains(GetMousePosition())) {
 					DrawLineV(
 						edit_wall_pos,
 						closest_corner_pos,
-						Maze::IsWallValid(edit_wall_from, closest_corner_to_mouse) ? GREEN : RED
+						maze.IsWallValid(edit_wall_from, closest_corner_to_mouse) ? GREEN : RED
 					);
 				} else {
 					DrawLineV(edit_wall_pos, GetMousePosition(), RED);
@@ -350,21 +472,26 @@ int main(int argc, char** argv) {
 			DrawCircleV(
 				state == MOVING_STARTING_COORD
 					? GetMousePosition()
-					: maze.CellToPos(solver->starting_coord),
-				MAZE_CELL_SIZE * 0.4f,
+					: maze_view.CellToPos(solver->starting_coord),
+				maze_view.CellSize() * 0.4f,
 				ORANGE
 			);
 		}
 
 		// Draw the solver on top of the maze
-		if (state == SOLVING_MAZE) {
-			solver->Draw(maze.position, show_floodfill_vals, roboto);
+		if (state == SOLVING_MAZE && !skipping) {
+			solver_view->Draw(show_floodfill_vals, roboto);
 		}
 
 		DrawUI();
 		EndDrawing();
 	}
 
+	if (skipping) {
+		skip_cancelled = true;
+		StopSkipping();
+	}
+
 	maze.SaveToFile("backup.maz", solver->starting_coord);
 	return 0;
 }
@@ -0,0 +1,105 @@
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "mapped_file.hpp"
+
+MappedFile::MappedFile() {
+
+}
+
+MappedFile::~MappedFile() {
+	Close();
+}
+
+int MappedFile::Open(const std::string& filename) {
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		return 0;
+	}
+
+	LARGE_INTEGER file_size;
+	if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0) {
+		if (file_size.QuadPart < MAPPED_FILE_MIN_MAP_SIZE) {
+			buffer.resize((size_t)file_size.QuadPart);
+			DWORD bytes_read = 0;
+			if (ReadFile(file, buffer.data(), (DWORD)buffer.size(), &bytes_read, NULL) && bytes_read == buffer.size()) {
+				data = buffer.data();
+			}
+		} else {
+			HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (mapping) {
+				data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+				mapped = data != nullptr;
+				CloseHandle(mapping);
+			}
+		}
+		if (data) {
+			size = (size_t)file_size.QuadPart;
+		}
+	}
+	CloseHandle(file);
+#else
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return 0;
+	}
+
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+		size_t file_size = (size_t)file_stat.st_size;
+		if (file_size < MAPPED_FILE_MIN_MAP_SIZE) {
+			buffer.resize(file_size);
+			size_t bytes_read = 0;
+			while (bytes_read < file_size) {
+				ssize_t result = read(fd, buffer.data() + bytes_read, file_size - bytes_read);
+				if (result <= 0) {
+					break;
+				}
+				bytes_read += (size_t)result;
+			}
+			if (bytes_read == file_size) {
+				data = buffer.data();
+			}
+		} else {
+			void* mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mapping != MAP_FAILED) {
+				data = (const uint8_t*)mapping;
+				mapped = true;
+			}
+		}
+		if (data) {
+			size = file_size;
+		}
+	}
+	close(fd);
+#endif
+
+	return data ? 1 : 0;
+}
+
+void MappedFile::Close() {
+	if (mapped) {
+#ifdef _WIN32
+		UnmapViewOfFile(data);
+#else
+		munmap((void*)data, size);
+#endif
+	}
+	data = nullptr;
+	size = 0;
+	mapped = false;
+}
@@ -1,75 +1,62 @@
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <string>
-#include <raylib.h>
-#include <raylib-cpp.hpp>
 #include <vector>
 
 #include "maze.hpp"
-#include "console.hpp"
+#include "log.hpp"
+#include "mapped_file.hpp"
+#include "work_stealing.hpp"
 
-namespace ray = raylib;
+#define STRINGIFY_VALUE(x) #x
+#define STRINGIFY(x) STRINGIFY_VALUE(x)
 
-Maze::Maze(Vector2 position) {
-	this->position = position;
+Maze::Maze(int rows, int cols) {
+	Resize(rows, cols);
+}
+
+Maze::~Maze() {
+
+}
+
+bool Maze::Contains(Point cell) const {
+	return cell.x >= 0 && cell.x < cols && cell.y >= 0 && cell.y < rows;
+}
+
+// Change the size of the maze, which clears its walls
+void Maze::Resize(int rows, int cols) {
+	version++;
+	this->rows = rows;
+	this->cols = cols;
+	horizontal_walls.Resize(rows + 1, cols);
+	vertical_walls.Resize(rows, cols + 1);
 	Clear();
 
 	// Set the goal of the maze to be in the center
-	this->goals = { };
-	Point mid = Point(MAZE_COLS / 2, MAZE_ROWS / 2);
+	this->goals.clear();
+	Point mid = Point(cols / 2, rows / 2);
 	this->goals.push_back(mid);
-	if (MAZE_COLS % 2 == 0) {
+	if (cols % 2 == 0) {
 		this->goals.push_back(mid - Point(1, 0));
 	}
-	if (MAZE_ROWS % 2 == 0) {
+	if (rows % 2 == 0) {
 		this->goals.push_back(mid - Point(0, 1));
 	}
-	if (MAZE_COLS % 2 == 0 && MAZE_ROWS % 2 == 0) {
+	if (cols % 2 == 0 && rows % 2 == 0) {
 		this->goals.push_back(mid - Point(1, 1));
 	}
 }
 
-Maze::~Maze() {
-
-}
-
-bool Maze::Contains(Vector2 pos) {
-	return !(pos.x < position.x
-		|| pos.x > position.x + MAZE_COLS * MAZE_CELL_SIZE
-		|| pos.y < position.y
-		|| pos.y > position.y + MAZE_ROWS * MAZE_CELL_SIZE);
-}
-
-Point Maze::ClosestCornerTo(Vector2 pos) {
-	if (!Contains(pos)) {
-		return Point(-1);
-	}
-
-	return Point(
-		(pos.x - position.x + MAZE_CELL_SIZE / 2.0f) / MAZE_CELL_SIZE,
-		(pos.y - position.y + MAZE_CELL_SIZE / 2.0f) / MAZE_CELL_SIZE
-	);
-}
-
-ray::Vector2 Maze::CornerToPos(Point coord) {
-	return ray::Vector2(
-		position.x + coord.x * MAZE_CELL_SIZE,
-		position.y + coord.y * MAZE_CELL_SIZE
-	);
-}
-
-ray::Vector2 Maze::CellToPos(Point coord) {
-	return CornerToPos(coord) + ray::Vector2(0.5f, 0.5f) * MAZE_CELL_SIZE;
-}
-
 // Given wall should only either be horizontal or vertical, and not fully lie on the edge
 bool Maze::IsWallValid(Point from_corner, Point to_corner) {
-	return (from_corner.y == to_corner.y && from_corner.x != to_corner.x && to_corner.y != 0 && to_corner.y != MAZE_ROWS)
-		|| (from_corner.y != to_corner.y && from_corner.x == to_corner.x && to_corner.x != 0 && to_corner.x != MAZE_COLS);
+	return (from_corner.y == to_corner.y && from_corner.x != to_corner.x && to_corner.y != 0 && to_corner.y != rows)
+		|| (from_corner.y != to_corner.y && from_corner.x == to_corner.x && to_corner.x != 0 && to_corner.x != cols);
 }
 
 // Set the state of multiple walls
 void Maze::SetWalls(Point from_corner, Point to_corner, bool state) {
+	version++;
 	if (from_corner.y == to_corner.y) {
 		int left = std::min(from_corner.x, to_corner.x);
 		int right = std::max(from_corner.x, to_corner.x);
@@ -94,56 +81,23 @@ bool Maze::WallAt(bool horizontal, Point coord) {
 
 // Set all walls other than edge walls to false 
 void Maze::Clear() {
-	for (int row = 0; row < MAZE_ROWS; row++) {
-		for (int col = 0; col < MAZE_COLS; col++) {
-			horizontal_walls[row][col] = false;
-			vertical_walls[row][col] = false;
-		}
+	version++;
+	horizontal_walls.Fill(false);
+	vertical_walls.Fill(false);
 
+	for (int row = 0; row < rows; row++) {
 		vertical_walls[row][0] = true;
-		vertical_walls[row][MAZE_COLS] = true;
+		vertical_walls[row][cols] = true;
 	}
 
-	for (int col = 0; col < MAZE_COLS; col++) {
+	for (int col = 0; col < cols; col++) {
 		horizontal_walls[0][col] = true;
-		horizontal_walls[MAZE_ROWS][col] = true;
-	}
-}
-
-void Maze::Draw(Color wall_clr, Color dot_clr) {
-	for (int row = 0; row < MAZE_ROWS; row++) {
-		for (int col = 0; col < MAZE_COLS; col++) {
-			Vector2 pos = CornerToPos(Point(col, row));
-
-			// Draw walls
-			if (vertical_walls[row][col]) {
-				DrawLineV(pos, CornerToPos(Point(col, row + 1)), wall_clr);
-			}
-			if (horizontal_walls[row][col]) {
-				DrawLineV(pos, CornerToPos(Point(col + 1, row)), wall_clr);
-			}
-
-			// Draw corner
-			DrawCircleV(pos, 3.0f, dot_clr);
-		}
-	}
-
-	// Draw the bottom and right edges of the maze
-	Vector2 edge = CornerToPos(Point(MAZE_COLS, MAZE_ROWS));
-	DrawLine(edge.x, position.y, edge.x, edge.y, wall_clr);
-	DrawLine(position.x, edge.y, edge.x, edge.y, wall_clr);
-
-	// Draw the bottom and right corners of the maze
-	for (int row = 0; row <= MAZE_ROWS; row++) {
-		DrawCircleV(CornerToPos(Point(MAZE_COLS, row)), 3.0f, dot_clr);
-	}
-	for (int col = 0; col < MAZE_COLS; col++) {
-		DrawCircleV(CornerToPos(Point(col, MAZE_ROWS)), 3.0f, dot_clr);
+		horizontal_walls[rows][col] = true;
 	}
 }
 
 // .maz files:
-// - Lines 1-2 lines represent the number of rows and columns of the maze
+// - Lines 1-2 lines represent the number of rows and columns of the maze (the maze is resized to match)
 // - Lines 3-4 lines contain the solver's starting row and column, respectively
 // - Next lines describe each row of the maze, with each character representing a cell:
 //     - Each character is either 0, 1, 2, or 3:
@@ -152,29 +106,30 @@ void Maze::Draw(Color wall_clr, Color dot_clr) {
 //     - 2 means only top wall exists
 //     - 3 means both left and top walls exist
 // - Right and bottom edges of the maze will automatically have walls
+// Every row must have exactly as many cells as there are columns, and only blank lines may follow the last row.
 
 int Maze::SaveToFile(std::string filename, Point starting_coord) {
 	std::ofstream file;
 	file.open(filename);
 	if (!file.is_open()) {
-		ConsoleError("Unable to open file: " + filename);
+		LogError("Unable to open file: " + filename);
 		return 0;
 	}
 
-	ConsoleLog("Saving to file: " + filename);
+	LogInfo("Saving to file: " + filename);
 
 	// Save maze size
-	file << std::to_string(MAZE_ROWS) << '\n';
-	file << std::to_string(MAZE_COLS) << '\n';
+	file << std::to_string(rows) << '\n';
+	file << std::to_string(cols) << '\n';
 
 	// Save starting coords for solver
 	file << std::to_string(starting_coord.y) << '\n';
 	file << std::to_string(starting_coord.x) << '\n';
 
 	// Save walls
-	for (int row = 0; row < MAZE_ROWS; row++) {
+	for (int row = 0; row < rows; row++) {
 		std::string line;
-		for (int col = 0; col < MAZE_COLS; col++) {
+		for (int col = 0; col < cols; col++) {
 			bool left_wall = vertical_walls[row][col];
 			bool top_wall = horizontal_walls[row][col];
 
@@ -192,82 +147,634 @@ int Maze::SaveToFile(std::string filename, Point starting_coord) {
 		file << line << '\n';
 	}
 
-	ConsoleLog("Saved maze to: " + filename);
+	LogInfo("Saved maze to: " + filename);
 
 	file.close();
 	return 1;
 }
 
+// Next line of a buffer, without its line ending ("\n" or "\r\n"). Returns false at the end of the buffer.
+static bool NextLine(const char** p, const char* end, const char** line, size_t* length) {
+	if (*p >= end) {
+		return false;
+	}
+
+	const char* line_end = (const char*)memchr(*p, '\n', end - *p);
+	if (!line_end) {
+		line_end = end;
+	}
+	*line = *p;
+	*length = line_end - *p;
+	if (*length > 0 && (*line)[*length - 1] == '\r') {
+		(*length)--;
+	}
+	*p = line_end < end ? line_end + 1 : end;
+	return true;
+}
+
+// Parse a line of non-negative numbers separated by spaces into values. Returns how many there are,
+// or -1 if the line holds anything else or more than max_count numbers.
+// Numbers too big for any maze are capped rather than overflowing.
+static int ParseNumbers(const char* line, size_t length, int* values, int max_count) {
+	int count = 0;
+	size_t i = 0;
+	while (true) {
+		while (i < length && (line[i] == ' ' || line[i] == '\t')) {
+			i++;
+		}
+		if (i == length) {
+			return count;
+		}
+		if (line[i] < '0' || line[i] > '9' || count == max_count) {
+			return -1;
+		}
+
+		int value = 0;
+		while (i < length && line[i] >= '0' && line[i] <= '9') {
+			value = value < (1 << 24) ? value * 10 + (line[i] - '0') : (1 << 28);
+			i++;
+		}
+		if (i < length && line[i] != ' ' && line[i] != '\t') {
+			return -1;
+		}
+		values[count++] = value;
+	}
+}
+
+// Take over the size, walls and goals of a maze parsed into a scratch Maze, so a file that fails to
+// parse never touches this one
+void Maze::Adopt(Maze& parsed) {
+	version++;
+	rows = parsed.rows;
+	cols = parsed.cols;
+	std::swap(horizontal_walls, parsed.horizontal_walls);
+	std::swap(vertical_walls, parsed.vertical_walls);
+	goals.swap(parsed.goals);
+}
+
+MazeFileError Maze::LoadFromBuffer(const char* data, size_t size, Point* starting_coord, int* error_line) {
+	Maze parsed;
+	Point parsed_start;
+	MazeFileError error = parsed.ParseMaz(data, size, &parsed_start, error_line);
+	if (error == MAZE_FILE_OK) {
+		Adopt(parsed);
+		*starting_coord = parsed_start;
+	}
+	return error;
+}
+
+MazeFileError Maze::ParseMaz(const char* data, size_t size, Point* starting_coord, int* error_line) {
+	const char* p = data;
+	const char* end = data + size;
+	const char* line;
+	size_t length;
+	int line_number = 0;
+	int header[4];
+
+	// Read maze size, then the starting coord for the solver
+	for (int i = 0; i < 4; i++) {
+		line_number++;
+		if (error_line) {
+			*error_line = line_number;
+		}
+		if (!NextLine(&p, end, &line, &length)) {
+			return i < 2 ? MAZE_FILE_NO_SIZE : MAZE_FILE_NO_START;
+		}
+		if (ParseNumbers(line, length, &header[i], 1) != 1) {
+			return MAZE_FILE_BAD_NUMBER;
+		}
+	}
+
+	int file_rows = header[0];
+	int file_cols = header[1];
+	if (file_rows < 1 || file_rows > MAZE_MAX_SIZE || file_cols < 1 || file_cols > MAZE_MAX_SIZE) {
+		if (error_line) {
+			*error_line = 1;
+		}
+		return MAZE_FILE_BAD_SIZE;
+	}
+	if (header[2] >= file_rows || header[3] >= file_cols) {
+		if (error_line) {
+			*error_line = 3;
+		}
+		return MAZE_FILE_BAD_START;
+	}
+
+	Resize(file_rows, file_cols);
+	*starting_coord = Point(header[3], header[2]);
+
+	// Load walls straight into the wall grids
+	MazeFileError error = MAZE_FILE_OK;
+	for (int row = 0; row < rows && error == MAZE_FILE_OK; row++) {
+		line_number++;
+		if (!NextLine(&p, end, &line, &length)) {
+			error = MAZE_FILE_MISSING_ROWS;
+			break;
+		}
+		if (length != (size_t)cols) {
+			error = MAZE_FILE_BAD_ROW_LENGTH;
+			break;
+		}
+
+		bool* left_walls = vertical_walls[row];
+		bool* top_walls = horizontal_walls[row];
+		for (int col = 0; col < cols; col++) {
+			unsigned int state = (unsigned char)line[col] - '0';
+			if (state > 3) {
+				error = MAZE_FILE_BAD_CELL;
+				break;
+			}
+			left_walls[col] = state & 1;
+			top_walls[col] = state >> 1;
+		}
+	}
+
+	// Only blank lines may follow
+	while (error == MAZE_FILE_OK && NextLine(&p, end, &line, &length)) {
+		line_number++;
+		if (length > 0) {
+			error = MAZE_FILE_EXTRA_LINES;
+		}
+	}
+
+	if (error != MAZE_FILE_OK && error_line) {
+		*error_line = line_number;
+	}
+	return error;
+}
+
+// Other maze file formats, as found in the public maze collections. All of them are imported with
+// the usual outer walls, the start in the bottom left corner and the goal in the center unless the
+// file marks them.
+//
+// Text mazes draw the walls in ASCII, with posts 4 characters apart and rows 2 lines apart:
+//     o---o---o
+//     | G     |
+//     o   o---o
+//     | S |   |
+//     o---o---o
+// Posts can be any character. Horizontal walls are "---" (or "___", "==="), vertical walls "|".
+// An S or G inside a cell marks the start and goal cells. Trailing spaces may be left out.
+//
+// Binary mazes are 256 bytes for a 16x16 maze (any square size works), one byte per cell in columns
+// from the bottom left, going up each column: bit 0 is the cell's north wall, then east, south and west.
+//
+// .num files have a line per cell, "x y north east south west", with (0, 0) the bottom left cell
+// and 1 for walls. Every cell needs a line.
+
+MazeFormat DetectMazeFormat(const char* data, size_t size) {
+	if (size == 0) {
+		return MAZE_FORMAT_UNKNOWN;
+	}
+
+	// Binary mazes hold nothing but wall bits, while the text formats always have printable characters
+	bool binary = true;
+	for (size_t i = 0; i < size && binary; i++) {
+		binary = (unsigned char)data[i] < 16;
+	}
+	if (binary) {
+		size_t side = 1;
+		while ((side + 1) * (side + 1) <= size) {
+			side++;
+		}
+		return side * side == size ? MAZE_FORMAT_BINARY : MAZE_FORMAT_UNKNOWN;
+	}
+
+	const char* line;
+	size_t length;
+	const char* p = data;
+	if (!NextLine(&p, data + size, &line, &length)) {
+		return MAZE_FORMAT_UNKNOWN;
+	}
+	int values[6];
+	int count = ParseNumbers(line, length, values, 6);
+	if (count == 1) {
+		return MAZE_FORMAT_MAZ;
+	} else if (count == 6) {
+		return MAZE_FORMAT_NUM;
+	} else if (length > 0 && line[0] != ' ' && line[0] != '\t') {
+		return MAZE_FORMAT_TEXT;
+	}
+	return MAZE_FORMAT_UNKNOWN;
+}
+
+MazeFileError Maze::ImportFromBuffer(const char* data, size_t size, Point* starting_coord, int* error_line,
+	Point* error_cell) {
+	Maze parsed;
+	Point parsed_start;
+	MazeFileError error = MAZE_FILE_UNKNOWN_FORMAT;
+	switch (DetectMazeFormat(data, size)) {
+	case MAZE_FORMAT_MAZ: error = parsed.ParseMaz(data, size, &parsed_start, error_line); break;
+	case MAZE_FORMAT_TEXT: error = parsed.ImportText(data, size, &parsed_start, error_line); break;
+	case MAZE_FORMAT_BINARY: error = parsed.ImportBinary((const uint8_t*)data, size, &parsed_start); break;
+	case MAZE_FORMAT_NUM: error = parsed.ImportNum(data, size, &parsed_start, error_line, error_cell); break;
+	default:
+		if (error_line) {
+			*error_line = 1;
+		}
+		break;
+	}
+
+	if (error == MAZE_FILE_OK) {
+		Adopt(parsed);
+		*starting_coord = parsed_start;
+	}
+	return error;
+}
+
+// Character of a text maze line, with any left out trailing spaces
+static char CharAt(const char* line, size_t length, size_t i) {
+	return i < length ? line[i] : ' ';
+}
+
+MazeFileError Maze::ImportText(const char* data, size_t size, Point* starting_coord, int* error_line) {
+	// The first line is the top row of posts and walls, and sets the width
+	const char* p = data;
+	const char* end = data + size;
+	const char* line;
+	size_t length;
+	if (!NextLine(&p, end, &line, &length)) {
+		if (error_line) {
+			*error_line = 1;
+		}
+		return MAZE_FILE_TRUNCATED;
+	}
+	while (length > 0 && line[length - 1] == ' ') {
+		length--;
+	}
+
+	// Count the lines up to the first blank one, which ends the maze
+	int line_count = 1;
+	const char* lines_start = p;
+	while (NextLine(&p, end, &line, &length) && length > 0) {
+		line_count++;
+	}
+	while (NextLine(&p, end, &line, &length)) {
+		if (length > 0) {
+			if (error_line) {
+				*error_line = line_count + 1;
+			}
+			return MAZE_FILE_EXTRA_LINES;
+		}
+	}
+
+	// Back to the first line, which was read above
+	p = data;
+	NextLine(&p, end, &line, &length);
+	while (length > 0 && line[length - 1] == ' ') {
+		length--;
+	}
+	int file_cols = (int)((length - 1) / 4);
+	int file_rows = (line_count - 1) / 2;
+	if (length % 4 != 1 || line_count % 2 != 1 || file_rows < 1 || file_cols < 1
+		|| file_rows > MAZE_MAX_SIZE || file_cols > MAZE_MAX_SIZE) {
+		if (error_line) {
+			*error_line = 1;
+		}
+		return MAZE_FILE_BAD_LAYOUT;
+	}
+	size_t width = length;
+
+	Resize(file_rows, file_cols);
+	*starting_coord = Point(0, rows - 1);
+	std::vector<Point> marked_goals;
+
+	// Alternate between lines of posts and horizontal walls, and lines of vertical walls and cells
+	MazeFileError error = MAZE_FILE_OK;
+	int line_number = 1;
+	p = lines_start;
+	for (int i = 0; i < line_count && error == MAZE_FILE_OK; i++) {
+		if (i > 0) {
+			line_number++;
+			if (!NextLine(&p, end, &line, &length)) {
+				error = MAZE_FILE_TRUNCATED;
+				break;
+			}
+		}
+		while (length > width && line[length - 1] == ' ') {
+			length--;
+		}
+		if (length > width) {
+			error = MAZE_FILE_BAD_LAYOUT;
+			break;
+		}
+
+		int row = i / 2;
+		if (i % 2 == 0) {
+			bool* top_walls = horizontal_walls[row];
+			for (int col = 0; col < cols; col++) {
+				size_t x = (size_t)col * 4 + 1;
+				char c = CharAt(line, length, x + 1);
+				bool wall = c == '-' || c == '_' || c == '=';
+				if ((!wall && c != ' ') || CharAt(line, length, x) != c || CharAt(line, length, x + 2) != c) {
+					error = MAZE_FILE_BAD_WALL;
+					break;
+				}
+				top_walls[col] = top_walls[col] || wall;
+			}
+		} else {
+			bool* left_walls = vertical_walls[row];
+			for (int col = 0; col <= cols; col++) {
+				char c = CharAt(line, length, (size_t)col * 4);
+				if (c != '|' && c != ' ') {
+					error = MAZE_FILE_BAD_WALL;
+					break;
+				}
+				left_walls[col] = left_walls[col] || c == '|';
+
+				for (size_t x = (size_t)col * 4 + 1; col < cols && x < (size_t)col * 4 + 4; x++) {
+					char marker = CharAt(line, length, x);
+					if (marker == 'S') {
+						*starting_coord = Point(col, row);
+					} else if (marker == 'G') {
+						marked_goals.push_back(Point(col, row));
+					}
+				}
+			}
+		}
+	}
+
+	if (error != MAZE_FILE_OK) {
+		if (error_line) {
+			*error_line = line_number;
+		}
+		return error;
+	}
+	if (!marked_goals.empty()) {
+		goals = marked_goals;
+	}
+	return MAZE_FILE_OK;
+}
+
+// Add the walls of a cell given with north up, as the binary and .num formats do
+void Maze::AddCellWalls(int col, int row, bool north, bool east, bool south, bool west) {
+	horizontal_walls[row][col] = horizontal_walls[row][col] || north;
+	horizontal_walls[row + 1][col] = horizontal_walls[row + 1][col] || south;
+	vertical_walls[row][col] = vertical_walls[row][col] || west;
+	vertical_walls[row][col + 1] = vertical_walls[row][col + 1] || east;
+}
+
+MazeFileError Maze::ImportBinary(const uint8_t* data, size_t size, Point* starting_coord) {
+	int side = 1;
+	while ((size_t)(side + 1) * (side + 1) <= size) {
+		side++;
+	}
+	if ((size_t)side * side != size || side > MAZE_MAX_SIZE) {
+		return MAZE_FILE_BAD_LAYOUT;
+	}
+
+	Resize(side, side);
+	*starting_coord = Point(0, rows - 1);
+	for (int x = 0; x < cols; x++) {
+		const uint8_t* column = data + (size_t)x * rows;
+		for (int y = 0; y < rows; y++) {
+			uint8_t walls = column[y];
+			AddCellWalls(x, rows - 1 - y, walls & 1, walls & 2, walls & 4, walls & 8);
+		}
+	}
+	return MAZE_FILE_OK;
+}
+
+// Report cell (x, y) of a .num file as missing, after its last line
+static MazeFileError MissingNumCell(int x, int y, int last_line, int* error_line, Point* error_cell) {
+	if (error_line) {
+		*error_line = last_line + 1;
+	}
+	if (error_cell) {
+		*error_cell = Point(x, y);
+	}
+	return MAZE_FILE_MISSING_CELL;
+}
+
+MazeFileError Maze::ImportNum(const char* data, size_t size, Point* starting_coord, int* error_line, Point* error_cell) {
+	// The size is only known once every cell has been seen, so read the lines twice
+	const char* end = data + size;
+	const char* line;
+	size_t length;
+	int values[6];
+	int file_cols = 0;
+	int file_rows = 0;
+	int line_number = 0;
+	size_t cell_lines = 0;
+	for (const char* p = data; NextLine(&p, end, &line, &length);) {
+		line_number++;
+		int count = ParseNumbers(line, length, values, 6);
+		if (count == 0) {
+			continue;
+		}
+		cell_lines++;
+		if (count != 6 || values[2] > 1 || values[3] > 1 || values[4] > 1 || values[5] > 1
+			|| values[0] >= MAZE_MAX_SIZE || values[1] >= MAZE_MAX_SIZE) {
+			if (error_line) {
+				*error_line = line_number;
+			}
+			return MAZE_FILE_BAD_LINE;
+		}
+		file_cols = std::max(file_cols, values[0] + 1);
+		file_rows = std::max(file_rows, values[1] + 1);
+	}
+
+	// Too few lines for the size the coordinates ask for. This is caught before allocating the maze, which a
+	// single line far out could make huge. At most cell_lines cells have a line, so one of the first
+	// cell_lines + 1 cells (in column order, as the files list them) is the first missing one.
+	if (cell_lines < (size_t)file_rows * file_cols) {
+		std::vector<bool> listed(cell_lines + 1, false);
+		for (const char* p = data; NextLine(&p, end, &line, &length);) {
+			if (ParseNumbers(line, length, values, 6) == 6) {
+				size_t cell = (size_t)values[0] * file_rows + values[1];
+				if (cell < listed.size()) {
+					listed[cell] = true;
+				}
+			}
+		}
+		size_t missing = std::find(listed.begin(), listed.end(), false) - listed.begin();
+		return MissingNumCell((int)(missing / file_rows), (int)(missing % file_rows), line_number, error_line, error_cell);
+	}
+
+	Resize(file_rows, file_cols);
+	*starting_coord = Point(0, rows - 1);
+	std::vector<bool> seen((size_t)rows * cols, false);
+	for (const char* p = data; NextLine(&p, end, &line, &length);) {
+		if (ParseNumbers(line, length, values, 6) == 6) {
+			AddCellWalls(values[0], rows - 1 - values[1], values[2], values[3], values[4], values[5]);
+			seen[(size_t)values[0] * rows + values[1]] = true;
+		}
+	}
+
+	// Every cell needs a line, or it would silently import without walls
+	for (int x = 0; x < cols; x++) {
+		for (int y = 0; y < rows; y++) {
+			if (!seen[(size_t)x * rows + y]) {
+				return MissingNumCell(x, y, line_number, error_line, error_cell);
+			}
+		}
+	}
+	return MAZE_FILE_OK;
+}
+
+const char* MazeFileErrorMessage(MazeFileError error) {
+	switch (error) {
+	case MAZE_FILE_OK: return "No error";
+	case MAZE_FILE_UNREADABLE: return "Unable to open file";
+	case MAZE_FILE_NO_SIZE: return "No maze size detected";
+	case MAZE_FILE_NO_START: return "No starting coordinates detected";
+	case MAZE_FILE_BAD_NUMBER: return "Expected a single number";
+	case MAZE_FILE_BAD_SIZE: return "Maze size is not between 1x1 and " STRINGIFY(MAZE_MAX_SIZE) "x" STRINGIFY(MAZE_MAX_SIZE);
+	case MAZE_FILE_BAD_START: return "Starting coordinates are outside of the maze";
+	case MAZE_FILE_MISSING_ROWS: return "Fewer rows than the maze size";
+	case MAZE_FILE_BAD_ROW_LENGTH: return "Row length doesn't match the maze size";
+	case MAZE_FILE_BAD_CELL: return "Invalid cell state (expected 0, 1, 2 or 3)";
+	case MAZE_FILE_EXTRA_LINES: return "Unexpected lines after the last row";
+	case MAZE_FILE_UNKNOWN_FORMAT: return "Unknown maze file format";
+	case MAZE_FILE_BAD_LAYOUT: return "Maze is not a grid of cells";
+	case MAZE_FILE_BAD_WALL: return "Invalid wall";
+	case MAZE_FILE_BAD_LINE: return "Expected \"x y north east south west\" with walls as 0 or 1";
+	case MAZE_FILE_MISSING_CELL: return "No line for cell";
+	case MAZE_FILE_TRUNCATED: return "File ends in the middle of the maze";
+	}
+	return "Unknown error";
+}
+
+// Map and parse a maze file of any format, without logging
+static MazeFileError ParseFile(Maze* maze, const std::string& filename, Point* starting_coord, int* error_line,
+	Point* error_cell) {
+	MappedFile file;
+	if (!file.Open(filename)) {
+		return MAZE_FILE_UNREADABLE;
+	}
+	return maze->ImportFromBuffer((const char*)file.Data(), file.Size(), starting_coord, error_line, error_cell);
+}
+
+static void LogFileError(const std::string& filename, MazeFileError error, int line, Point cell) {
+	if (error == MAZE_FILE_UNREADABLE) {
+		LogError("Unable to open file: " + filename);
+	} else if (error == MAZE_FILE_MISSING_CELL) {
+		LogError(filename + ":" + std::to_string(line) + ": " + MazeFileErrorMessage(error)
+			+ " (" + std::to_string(cell.x) + ", " + std::to_string(cell.y) + ")");
+	} else {
+		LogError(filename + ":" + std::to_string(line) + ": " + MazeFileErrorMessage(error));
+	}
+}
+
 int Maze::LoadFromFile(std::string filename, Point* starting_coord) {
-	std::ifstream file;
-	file.open(filename);
-	if (!file.is_open()) {
-		ConsoleError("Unable to open file: " + filename);
+	int line = 0;
+	Point cell = Point(0, 0);
+	MazeFileError error = ParseFile(this, filename, starting_coord, &line, &cell);
+	if (error != MAZE_FILE_OK) {
+		LogFileError(filename, error, line, cell);
 		return 0;
 	}
 
-	ConsoleLog("Loading file: " + filename);
+	LogInfo("Loaded maze: " + filename);
+	return 1;
+}
 
-	// Verify maze size
-	std::string row_line, col_line;
-	if (std::getline(file, row_line) && std::getline(file, col_line)) {
-		if (std::stoi(row_line) != MAZE_ROWS || std::stoi(col_line) != MAZE_COLS) {
-			ConsoleError(
-				"Maze file's size (" + row_line + "x" + col_line
-				+ ") doesn't match simulation size ("
-				+ std::to_string(MAZE_ROWS) + "x" + std::to_string(MAZE_COLS) + ")");
-			return 0;
+int LoadMazeFiles(const std::vector<std::string>& filenames, std::vector<Maze>& mazes,
+	std::vector<Point>& starting_coords, std::vector<MazeFileError>& errors, int thread_count) {
+	int count = (int)filenames.size();
+	std::vector<int> lines(count, 0);
+	std::vector<Point> cells(count, Point(0, 0));
+	mazes.resize(count);
+	starting_coords.resize(count);
+	errors.assign(count, MAZE_FILE_OK);
+
+	ParallelFor(count, thread_count, [&](int index, int) {
+		errors[index] = ParseFile(&mazes[index], filenames[index], &starting_coords[index], &lines[index], &cells[index]);
+	});
+
+	int loaded = 0;
+	for (int i = 0; i < count; i++) {
+		if (errors[i] == MAZE_FILE_OK) {
+			loaded++;
+		} else {
+			LogFileError(filenames[i], errors[i], lines[i], cells[i]);
 		}
-	} else {
-		ConsoleError("No maze size detected in file: " + filename);
+	}
+	return loaded;
+}
+
+// Binary maze records (all numbers are little-endian uint16):
+// - Number of rows and columns
+// - Solver's starting row and column
+// - Number of goals, followed by the row and column of each goal
+// - Walls, 2 bits per cell in row-major order, 4 cells per byte starting from the low bits.
+//   Like .maz files, bit 0 is the cell's left wall and bit 1 its top wall.
+
+static void WriteU16(std::vector<uint8_t>& out, int value) {
+	out.push_back((uint8_t)value);
+	out.push_back((uint8_t)(value >> 8));
+}
+
+static int ReadU16(const uint8_t* p) {
+	return p[0] | p[1] << 8;
+}
+
+void Maze::SaveToRecord(std::vector<uint8_t>& record, Point starting_coord) {
+	WriteU16(record, rows);
+	WriteU16(record, cols);
+	WriteU16(record, starting_coord.y);
+	WriteU16(record, starting_coord.x);
+	WriteU16(record, (int)goals.size());
+	for (Point& goal : goals) {
+		WriteU16(record, goal.y);
+		WriteU16(record, goal.x);
+	}
+
+	size_t walls_start = record.size();
+	record.resize(walls_start + ((size_t)rows * cols + 3) / 4, 0);
+	uint8_t* walls = record.data() + walls_start;
+	size_t cell = 0;
+	for (int row = 0; row < rows; row++) {
+		for (int col = 0; col < cols; col++, cell++) {
+			int bits = vertical_walls[row][col] | horizontal_walls[row][col] << 1;
+			walls[cell / 4] |= bits << (cell % 4 * 2);
+		}
+	}
+}
+
+int Maze::LoadFromRecord(const uint8_t* record, size_t size, Point* starting_coord) {
+	if (size < 10) {
 		return 0;
 	}
 
-	// Load starting coord for solver
-	if (std::getline(file, row_line) && std::getline(file, col_line)) {
-		starting_coord->y = std::stoi(row_line);
-		starting_coord->x = std::stoi(col_line);
-	} else {
-		ConsoleLog("No starting coordinates detected in file: " + filename);
+	int record_rows = ReadU16(record);
+	int record_cols = ReadU16(record + 2);
+	int starting_row = ReadU16(record + 4);
+	int starting_col = ReadU16(record + 6);
+	int goal_count = ReadU16(record + 8);
+	if (record_rows < 1 || record_rows > MAZE_MAX_SIZE || record_cols < 1 || record_cols > MAZE_MAX_SIZE
+		|| starting_row >= record_rows || starting_col >= record_cols || goal_count == 0) {
 		return 0;
 	}
 
-	// Load walls
-	std::string line;
-	for (int row = 0; row < MAZE_ROWS && std::getline(file, line); row++) {
-		int col = 0;
-		for (char& c : line) {
-			switch (c) {
-			case '0':
-				horizontal_walls[row][col] = false;
-				vertical_walls[row][col] = false;
-				break;
-			case '1':
-				horizontal_walls[row][col] = false;
-				vertical_walls[row][col] = true;
-				break;
-			case '2':
-				horizontal_walls[row][col] = true;
-				vertical_walls[row][col] = false;
-				break;
-			case '3':
-				horizontal_walls[row][col] = true;
-				vertical_walls[row][col] = true;
-				break;
-			case '\r':
-			case '\n':
-			case '\0':
-				break;
-			default:
-				ConsoleError(std::string("Invalid cell state: ") + c);
-				return 0;
-			}
-			col++;
+	size_t walls_start = 10 + (size_t)goal_count * 4;
+	if (size < walls_start + ((size_t)record_rows * record_cols + 3) / 4) {
+		return 0;
+	}
+	for (int i = 0; i < goal_count; i++) {
+		const uint8_t* goal = record + 10 + i * 4;
+		if (ReadU16(goal) >= record_rows || ReadU16(goal + 2) >= record_cols) {
+			return 0;
 		}
 	}
 
-	ConsoleLog("Loaded maze: " + filename);
+	Resize(record_rows, record_cols);
+	*starting_coord = Point(starting_col, starting_row);
+	goals.clear();
+	for (int i = 0; i < goal_count; i++) {
+		const uint8_t* goal = record + 10 + i * 4;
+		goals.push_back(Point(ReadU16(goal + 2), ReadU16(goal)));
+	}
 
-	file.close();
+	// Resize() put up the outer walls, which stay whatever the record's bits for them say
+	const uint8_t* walls = record + walls_start;
+	size_t cell = 0;
+	for (int row = 0; row < rows; row++) {
+		for (int col = 0; col < cols; col++, cell++) {
+			int bits = walls[cell / 4] >> (cell % 4 * 2);
+			vertical_walls[row][col] = vertical_walls[row][col] || (bits & 1);
+			horizontal_walls[row][col] = horizontal_walls[row][col] || (bits & 2);
+		}
+	}
 	return 1;
 }
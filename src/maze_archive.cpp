@@ -0,0 +1,127 @@
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "maze_archive.hpp"
+#include "log.hpp"
+
+static uint64_t ReadU64(const uint8_t* p) {
+	uint64_t value = 0;
+	for (int i = 7; i >= 0; i--) {
+		value = value << 8 | p[i];
+	}
+	return value;
+}
+
+static void WriteU64(std::ofstream& file, uint64_t value) {
+	uint8_t bytes[8];
+	for (int i = 0; i < 8; i++) {
+		bytes[i] = (uint8_t)(value >> (i * 8));
+	}
+	file.write((const char*)bytes, 8);
+}
+
+MazeArchive::MazeArchive() {
+
+}
+
+MazeArchive::~MazeArchive() {
+	Close();
+}
+
+// Records come after the header and the index, which has an offset per maze and one for the end
+static uint64_t RecordsStart(uint64_t maze_count) {
+	return MAZE_ARCHIVE_HEADER_SIZE + (maze_count + 1) * 8;
+}
+
+uint64_t MazeArchive::RecordOffset(int index) const {
+	return ReadU64(file.Data() + MAZE_ARCHIVE_HEADER_SIZE + (size_t)index * 8);
+}
+
+int MazeArchive::Open(std::string filename) {
+	Close();
+
+	if (!file.Open(filename)) {
+		LogError("Unable to open file: " + filename);
+		return 0;
+	}
+
+	// Check the header and that the index fits. Record offsets are checked as the records are loaded.
+	const uint8_t* data = file.Data();
+	bool valid = file.Size() >= MAZE_ARCHIVE_HEADER_SIZE && !memcmp(data, MAZE_ARCHIVE_MAGIC, 4);
+	uint64_t maze_count = 0;
+	for (int i = 3; i >= 0 && valid; i--) {
+		maze_count = maze_count << 8 | data[4 + i];
+	}
+	valid = valid && maze_count < INT32_MAX && RecordsStart(maze_count) <= file.Size();
+	count = valid ? (int)maze_count : 0;
+
+	if (!valid) {
+		LogError("Invalid maze archive: " + filename);
+		Close();
+		return 0;
+	}
+	return 1;
+}
+
+void MazeArchive::Close() {
+	file.Close();
+	count = 0;
+}
+
+int MazeArchive::Load(int index, Maze* maze, Point* starting_coord) const {
+	if (index < 0 || index >= count) {
+		return 0;
+	}
+
+	uint64_t start = RecordOffset(index);
+	uint64_t end = RecordOffset(index + 1);
+	if (start < RecordsStart(count) || start > end || end > file.Size()) {
+		return 0;
+	}
+	return maze->LoadFromRecord(file.Data() + start, (size_t)(end - start), starting_coord);
+}
+
+void MazeArchiveWriter::Add(Maze& maze, Point starting_coord) {
+	maze.SaveToRecord(records, starting_coord);
+	record_ends.push_back(records.size());
+}
+
+int MazeArchiveWriter::SaveToFile(std::string filename) {
+	std::ofstream file;
+	file.open(filename, std::ios::binary);
+	if (!file.is_open()) {
+		LogError("Unable to open file: " + filename);
+		return 0;
+	}
+
+	LogInfo("Saving to file: " + filename);
+
+	// Header
+	uint32_t maze_count = (uint32_t)record_ends.size();
+	uint8_t header[MAZE_ARCHIVE_HEADER_SIZE];
+	memcpy(header, MAZE_ARCHIVE_MAGIC, 4);
+	for (int i = 0; i < 4; i++) {
+		header[4 + i] = (uint8_t)(maze_count >> (i * 8));
+	}
+	file.write((const char*)header, sizeof(header));
+
+	// Index
+	uint64_t records_start = RecordsStart(maze_count);
+	WriteU64(file, records_start);
+	for (uint64_t end : record_ends) {
+		WriteU64(file, records_start + end);
+	}
+
+	// Records
+	file.write((const char*)records.data(), records.size());
+	file.close();
+	if (!file) {
+		LogError("Unable to write file: " + filename);
+		return 0;
+	}
+
+	LogInfo("Saved " + std::to_string(maze_count) + " maze(s) to: " + filename);
+	return 1;
+}
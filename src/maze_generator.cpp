@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "maze_generator.hpp"
+
+static const char* algorithm_names[MAZE_ALGORITHM_COUNT] = {
+	"backtracker", "kruskal", "braid", "loops", "competition"
+};
+
+const char* MazeAlgorithmName(MazeAlgorithm algorithm) {
+	return algorithm >= 0 && algorithm < MAZE_ALGORITHM_COUNT ? algorithm_names[algorithm] : "unknown";
+}
+
+int ParseMazeAlgorithm(const std::string& name, MazeAlgorithm* algorithm) {
+	for (int i = 0; i < MAZE_ALGORITHM_COUNT; i++) {
+		if (name == algorithm_names[i]) {
+			*algorithm = (MazeAlgorithm)i;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+MazeGenerator::MazeGenerator() {
+	Seed(0);
+}
+
+MazeGenerator::~MazeGenerator() {
+
+}
+
+static uint64_t RotateLeft(uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+uint64_t MazeGenerator::Next() {
+	uint64_t result = RotateLeft(state[1] * 5, 7) * 9;
+	uint64_t t = state[1] << 17;
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= t;
+	state[3] = RotateLeft(state[3], 45);
+	return result;
+}
+
+// Random number in [0, n)
+int MazeGenerator::Below(int n) {
+	return (int)(((Next() >> 32) * (uint64_t)n) >> 32);
+}
+
+// Spread the seed over the whole state with splitmix64, so nearby seeds give unrelated mazes
+void MazeGenerator::Seed(uint64_t seed) {
+	for (int i = 0; i < 4; i++) {
+		seed += 0x9E3779B97F4A7C15ull;
+		uint64_t z = seed;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		state[i] = z ^ (z >> 31);
+	}
+}
+
+bool MazeGenerator::IsWall(int edge) {
+	int cell = edge / 2;
+	int row = cell / cols;
+	int col = cell % cols;
+	return edge % 2 ? maze->vertical_walls[row][col + 1] : maze->horizontal_walls[row + 1][col];
+}
+
+void MazeGenerator::RemoveWall(int edge) {
+	int cell = edge / 2;
+	int row = cell / cols;
+	int col = cell % cols;
+	if (edge % 2) {
+		maze->vertical_walls[row][col + 1] = false;
+	} else {
+		maze->horizontal_walls[row + 1][col] = false;
+	}
+}
+
+// The wall between two neighboring cells
+int MazeGenerator::EdgeBetween(int cell, int neighbor) {
+	int first = std::min(cell, neighbor);
+	return first * 2 + (std::max(cell, neighbor) - first == 1);
+}
+
+// The cells next to cell, returns how many there are
+int MazeGenerator::Neighbors(int cell, int* neighbors) {
+	int row = cell / cols;
+	int col = cell % cols;
+	int count = 0;
+	if (row > 0) neighbors[count++] = cell - cols;
+	if (row < rows - 1) neighbors[count++] = cell + cols;
+	if (col > 0) neighbors[count++] = cell - 1;
+	if (col < cols - 1) neighbors[count++] = cell + 1;
+	return count;
+}
+
+int MazeGenerator::FindSet(int cell) {
+	while (parents[cell] != cell) {
+		parents[cell] = parents[parents[cell]];
+		cell = parents[cell];
+	}
+	return cell;
+}
+
+// Depth-first carve from start through every cell not visited yet
+void MazeGenerator::Backtrack(int start) {
+	stack.clear();
+	stack.push_back(start);
+	visited[start] = 1;
+
+	int neighbors[4];
+	while (!stack.empty()) {
+		int cell = stack.back();
+		int count = 0;
+		int all_count = Neighbors(cell, neighbors);
+		for (int i = 0; i < all_count; i++) {
+			if (!visited[neighbors[i]]) {
+				neighbors[count++] = neighbors[i];
+			}
+		}
+
+		if (count == 0) {
+			stack.pop_back();
+			continue;
+		}
+		int next = neighbors[Below(count)];
+		RemoveWall(EdgeBetween(cell, next));
+		visited[next] = 1;
+		stack.push_back(next);
+	}
+}
+
+// Remove the walls between sets of connected cells in random order
+void MazeGenerator::Kruskal() {
+	edges.clear();
+	for (int cell = 0; cell < rows * cols; cell++) {
+		if (cell / cols < rows - 1) edges.push_back(cell * 2);
+		if (cell % cols < cols - 1) edges.push_back(cell * 2 + 1);
+	}
+	for (int i = (int)edges.size() - 1; i > 0; i--) {
+		std::swap(edges[i], edges[Below(i + 1)]);
+	}
+
+	parents.resize(rows * cols);
+	for (int i = 0; i < rows * cols; i++) {
+		parents[i] = i;
+	}
+	for (int edge : edges) {
+		int cell = edge / 2;
+		int a = FindSet(cell);
+		int b = FindSet(edge % 2 ? cell + 1 : cell + cols);
+		if (a != b) {
+			parents[a] = b;
+			RemoveWall(edge);
+		}
+	}
+}
+
+// Open every dead end into a neighbor, preferring neighbors that are dead ends too
+void MazeGenerator::Braid() {
+	int neighbors[4];
+	for (int cell = 0; cell < rows * cols; cell++) {
+		int count = Neighbors(cell, neighbors);
+		int walled[4];
+		int walled_count = 0;
+		for (int i = 0; i < count; i++) {
+			if (IsWall(EdgeBetween(cell, neighbors[i]))) {
+				walled[walled_count++] = neighbors[i];
+			}
+		}
+		if (walled_count != count - 1 || walled_count == 0) {
+			continue;
+		}
+
+		int dead_ends[4];
+		int dead_end_count = 0;
+		for (int i = 0; i < walled_count; i++) {
+			int neighbor_neighbors[4];
+			int neighbor_count = Neighbors(walled[i], neighbor_neighbors);
+			int open = 0;
+			for (int j = 0; j < neighbor_count; j++) {
+				open += !IsWall(EdgeBetween(walled[i], neighbor_neighbors[j]));
+			}
+			if (open == 1) {
+				dead_ends[dead_end_count++] = walled[i];
+			}
+		}
+
+		int next = dead_end_count > 0 ? dead_ends[Below(dead_end_count)] : walled[Below(walled_count)];
+		RemoveWall(EdgeBetween(cell, next));
+	}
+}
+
+// Remove random interior walls. Cells marked 2 in visited (the start and goal area) keep their walls.
+void MazeGenerator::AddLoops(bool keep_marked_closed) {
+	int remaining = (int)(rows * cols * MAZE_GENERATOR_LOOPS_PER_CELL);
+	for (int attempt = 0; attempt < rows * cols && remaining > 0; attempt++) {
+		int cell = Below(rows * cols);
+		bool east = Below(2);
+		if (east ? cell % cols == cols - 1 : cell / cols == rows - 1) {
+			continue;
+		}
+
+		int neighbor = east ? cell + 1 : cell + cols;
+		if (keep_marked_closed && (visited[cell] == 2 || visited[neighbor] == 2)) {
+			continue;
+		}
+		int edge = cell * 2 + east;
+		if (IsWall(edge)) {
+			RemoveWall(edge);
+			remaining--;
+		}
+	}
+}
+
+// Like a competition maze: the start is a dead end in the bottom left corner opening to the north,
+// and the goal area is open inside with a single entrance
+void MazeGenerator::Competition() {
+	int start = (rows - 1) * cols;
+	if (rows < 4 || cols < 4) {
+		Backtrack(start);
+		return;
+	}
+
+	for (Point& goal : maze->goals) {
+		visited[goal.y * cols + goal.x] = 2;
+	}
+	for (Point& goal : maze->goals) {
+		int cell = goal.y * cols + goal.x;
+		int neighbors[4];
+		int count = Neighbors(cell, neighbors);
+		for (int i = 0; i < count; i++) {
+			if (visited[neighbors[i]] == 2) {
+				RemoveWall(EdgeBetween(cell, neighbors[i]));
+			}
+		}
+	}
+
+	visited[start] = 2;
+	RemoveWall(EdgeBetween(start, start - cols));
+	Backtrack(start - cols);
+
+	// Open a single entrance into the goal area
+	edges.clear();
+	for (Point& goal : maze->goals) {
+		int cell = goal.y * cols + goal.x;
+		int neighbors[4];
+		int count = Neighbors(cell, neighbors);
+		for (int i = 0; i < count; i++) {
+			if (visited[neighbors[i]] != 2) {
+				edges.push_back(EdgeBetween(cell, neighbors[i]));
+			}
+		}
+	}
+	RemoveWall(edges[Below((int)edges.size())]);
+
+	AddLoops(true);
+}
+
+void MazeGenerator::Generate(Maze* maze, int rows, int cols, MazeAlgorithm algorithm, uint64_t seed,
+	Point* starting_coord) {
+	this->maze = maze;
+	this->rows = rows;
+	this->cols = cols;
+	Seed(seed);
+
+	maze->Resize(rows, cols);
+	maze->horizontal_walls.Fill(true);
+	maze->vertical_walls.Fill(true);
+	visited.assign(rows * cols, 0);
+	*starting_coord = Point(0, rows - 1);
+
+	int start = (rows - 1) * cols;
+	switch (algorithm) {
+	case MAZE_ALGORITHM_KRUSKAL:
+		Kruskal();
+		break;
+	case MAZE_ALGORITHM_BRAID:
+		Backtrack(start);
+		Braid();
+		break;
+	case MAZE_ALGORITHM_LOOPS:
+		Backtrack(start);
+		AddLoops(false);
+		break;
+	case MAZE_ALGORITHM_COMPETITION:
+		Competition();
+		break;
+	default:
+		Backtrack(start);
+		break;
+	}
+}
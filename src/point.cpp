@@ -1,11 +1,11 @@
 #include "point.hpp"
 
-Point::Point(int8_t x, int8_t y) {
+Point::Point(int16_t x, int16_t y) {
 	this->x = x;
 	this->y = y;
 }
 
-Point::Point(int8_t a) {
+Point::Point(int16_t a) {
 	this->x = this->y = a;
 }
 
@@ -13,10 +13,6 @@ Point::Point() { }
 
 Point::~Point() { }
 
-ray::Vector2 Point::ToVec2() {
-	return ray::Vector2(x, y);
-}
-
 Point Point::operator + (Point p) {
 	return Point(x + p.x, y + p.y);
 }
@@ -53,28 +49,28 @@ void Point::operator /= (Point p) {
 	y /= p.y;
 }
 
-Point Point::operator * (int8_t n) {
+Point Point::operator * (int16_t n) {
 	return Point(x * n, y * n);
 }
 
-void Point::operator *= (int8_t n) {
+void Point::operator *= (int16_t n) {
 	x *= n;
 	y *= n;
 }
 
-Point Point::operator / (int8_t n) {
+Point Point::operator / (int16_t n) {
 	return Point(x / n, y / n);
 }
 
-void Point::operator /= (int8_t n) {
+void Point::operator /= (int16_t n) {
 	x /= n;
 	y /= n;
 }
 
-bool Point::operator == (Point p) {
+bool Point::operator == (Point p) const {
 	return x == p.x && y == p.y;
 }
 
-bool Point::operator != (Point p) {
+bool Point::operator != (Point p) const {
 	return x != p.x || y != p.y;
 }
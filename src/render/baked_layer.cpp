@@ -0,0 +1,54 @@
+#include <raylib.h>
+
+#include "render/baked_layer.hpp"
+
+BakedLayer::BakedLayer(int padding) {
+	this->padding = padding;
+}
+
+BakedLayer::~BakedLayer() {
+
+}
+
+void BakedLayer::Invalidate() {
+	valid = false;
+}
+
+bool BakedLayer::Begin(int width, int height) {
+	int texture_width = width + 2 * padding;
+	int texture_height = height + 2 * padding;
+	if (texture.id == 0 || texture.texture.width != texture_width || texture.texture.height != texture_height) {
+		if (texture.id != 0) {
+			UnloadRenderTexture(texture);
+		}
+		texture = LoadRenderTexture(texture_width, texture_height);
+		valid = false;
+	}
+	if (valid) {
+		return false;
+	}
+
+	BeginTextureMode(texture);
+	ClearBackground(BLANK);
+	return true;
+}
+
+Vector2 BakedLayer::Origin() {
+	return { (float)padding, (float)padding };
+}
+
+void BakedLayer::End() {
+	EndTextureMode();
+	valid = true;
+}
+
+void BakedLayer::Draw(Vector2 position, Color tint) {
+	if (texture.id == 0) {
+		return;
+	}
+
+	// Render textures are stored upside down
+	Rectangle source = { 0.0f, 0.0f, (float)texture.texture.width, -(float)texture.texture.height };
+	Vector2 corner = { position.x - padding, position.y - padding };
+	DrawTextureRec(texture.texture, source, corner, tint);
+}
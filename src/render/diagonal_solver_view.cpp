@@ -0,0 +1,174 @@
+#include <raylib.h>
+#include <raygui.h>
+
+#include "render/diagonal_solver_view.hpp"
+#include "direction.hpp"
+
+DiagonalSolverView::DiagonalSolverView(DiagonalSolver* solver, MazeView* maze_view) {
+	this->solver = solver;
+	this->maze_view = maze_view;
+}
+
+DiagonalSolverView::~DiagonalSolverView() {
+
+}
+
+void DiagonalSolverView::DrawPath(const std::vector<PathNode>& path, Color clr) {
+	float cell_size = maze_view->CellSize();
+	ray::Vector2 from = maze_view->CellToPos(solver->coord);
+	for (int i = path.size() - 1; i >= 0; i--) {
+		bool horizontal = path[i].horizontal;
+		Point edge_coord = path[i].edge_coord;
+		ray::Vector2 to = maze_view->CornerToPos(edge_coord) + (horizontal
+			? ray::Vector2(cell_size / 2.0f, 0.0f)
+			: ray::Vector2(0.0f, cell_size / 2.0f));
+
+		DrawLineEx(from, to, 3.0f, clr);
+		from = to;
+	}
+}
+
+// Draw the known walls in white, with the top left corner of the maze at origin
+void DiagonalSolverView::DrawKnownWalls(ray::Vector2 origin, float cell_size) {
+	for (int row = 0; row <= solver->rows; row++) {
+		for (int col = 0; col <= solver->cols; col++) {
+			for (int horizontal = 0; horizontal < 2; horizontal++) {
+				if (solver->edges[horizontal][row][col].wall_exists) {
+					ray::Vector2 from = origin + ray::Vector2(col, row) * cell_size;
+					ray::Vector2 to = from + (horizontal
+						? ray::Vector2(cell_size, 0.0f)
+						: ray::Vector2(0.0f, cell_size));
+					DrawLineV(from, to, WHITE);
+				}
+			}
+		}
+	}
+}
+
+void DiagonalSolverView::Draw(bool show_floodfill_vals, Font floodfill_font) {
+	float cell_size = maze_view->CellSize();
+
+	// Draw known walls, baked again only when they change
+	if (baked_walls_version != solver->known_walls_version || baked_cell_size != cell_size) {
+		known_walls_layer.Invalidate();
+		baked_walls_version = solver->known_walls_version;
+		baked_cell_size = cell_size;
+	}
+	if (known_walls_layer.Begin(maze_view->PixelWidth(), maze_view->PixelHeight())) {
+		DrawKnownWalls(known_walls_layer.Origin(), cell_size);
+		known_walls_layer.End();
+	}
+	known_walls_layer.Draw(maze_view->position, BLACK);
+
+	// Draw current coord
+	DrawCircleV(maze_view->CellToPos(solver->coord), cell_size * 0.4f, ORANGE);
+
+	// Show row and column labels
+	for (int i = 0; i < solver->rows; i++) {
+		Vector2 p = maze_view->CornerToPos(Point(-1, i));
+		GuiLabel(
+			ray::Rectangle(p.x + 10.0f, p.y, 50.0f, 50.0f),
+			std::to_string(i).c_str()
+		);
+	}
+	for (int i = 0; i < solver->cols; i++) {
+		Vector2 p = maze_view->CornerToPos(Point(i, solver->rows));
+		GuiLabel(
+			ray::Rectangle(p.x + 10.0f, p.y, 50.0f, 50.0f),
+			std::to_string(i).c_str()
+		);
+	}
+
+	if (solver->UpdateFinishedPaths()) {
+		// Solution and alternative solution, flooded once per finished run, and the quickest run through the solution's cells
+		DrawPath(solver->solution_path, DARKBLUE);
+		DrawPath(solver->alternative_path, BLACK);
+		DrawPath(solver->fast_path, DARKGREEN);
+	} else {
+		// Current path
+		DrawPath(solver->path, DARKBLUE);
+	}
+
+	// Show unvisited coords of a potentially better path
+	for (Point target : solver->target_coords) {
+		DrawCircleLinesV(maze_view->CellToPos(target), cell_size * 0.4f, BLACK);
+	}
+
+	// Show manhattan distance of each cell from the goal
+	if (!show_floodfill_vals || cell_size < FLOODFILL_MIN_CELL_SIZE) {
+		return;
+	}
+
+	if (baked_floodfill_version != solver->floodfill_version || baked_floodfill_cell_size != cell_size) {
+		floodfill_layer.Invalidate();
+		baked_floodfill_version = solver->floodfill_version;
+		baked_floodfill_cell_size = cell_size;
+	}
+	if (floodfill_layer.Begin(maze_view->PixelWidth(), maze_view->PixelHeight())) {
+		DrawFloodfillValues(floodfill_layer.Origin(), cell_size, floodfill_font);
+		floodfill_layer.End();
+	}
+	floodfill_layer.Draw(maze_view->position, WHITE);
+}
+
+// Draw the floodfill value, direction and same direction count of each edge,
+// with the top left corner of the maze at origin
+void DiagonalSolverView::DrawFloodfillValues(ray::Vector2 origin, float cell_size, Font floodfill_font) {
+	const int TEXT_HEIGHT = 13;
+	int default_text_size = GuiGetStyle(DEFAULT, TEXT_SIZE);
+	int default_text_clr = GuiGetStyle(DEFAULT, TEXT_COLOR_NORMAL);
+
+	GuiSetFont(floodfill_font);
+
+	for (int i = 0; i < solver->rows; i++) {
+		for (int j = 0; j < solver->cols; j++) {
+			char buffer[16];
+			float x, y, ff_val_f;
+			ray::Vector2 p = origin + ray::Vector2(j, i) * cell_size;
+
+			// Horizontal floodfill values
+			if ((ff_val_f = FF_VAL_TO_FLOAT(solver->edges[true][i][j].ff_val)) >= 0.0f) {
+				snprintf(
+					buffer,
+					sizeof(buffer),
+					"%.1f\n%s,%d",
+					ff_val_f,
+					DirToStr(solver->edges[true][i][j].dir).c_str(),
+					solver->edges[true][i][j].same_dir
+				);
+
+				x = p.x + (cell_size - GuiGetTextWidth(buffer)) / 2.0f;
+				y = p.y - TEXT_HEIGHT / 2.0f;
+
+				GuiSetStyle(DEFAULT, TEXT_COLOR_NORMAL, ColorToInt(RED));
+
+				GuiSetStyle(DEFAULT, TEXT_SIZE, TEXT_HEIGHT);
+				GuiLabel(ray::Rectangle(x, y, 50.0f, TEXT_HEIGHT), buffer);
+			}
+
+			// Vertical floodfill values
+			if ((ff_val_f = FF_VAL_TO_FLOAT(solver->edges[false][i][j].ff_val)) >= 0.0f) {
+				snprintf(
+					buffer,
+					sizeof(buffer),
+					"%.1f\n%s,%d",
+					ff_val_f,
+					DirToStr(solver->edges[false][i][j].dir).c_str(),
+					solver->edges[false][i][j].same_dir
+				);
+
+				x = p.x - GuiGetTextWidth(buffer) / 2.0f;
+				y = p.y + (cell_size - TEXT_HEIGHT) / 2.0f;
+
+				GuiSetStyle(DEFAULT, TEXT_COLOR_NORMAL, ColorToInt(BLUE));
+
+				GuiSetStyle(DEFAULT, TEXT_SIZE, TEXT_HEIGHT);
+				GuiLabel(ray::Rectangle(x, y, 50.0f, TEXT_HEIGHT), buffer);
+			}
+		}
+	}
+
+	GuiSetFont(GetFontDefault());
+	GuiSetStyle(DEFAULT, TEXT_SIZE, default_text_size);
+	GuiSetStyle(DEFAULT, TEXT_COLOR_NORMAL, default_text_clr);
+}
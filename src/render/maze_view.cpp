@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <cmath>
+
+#include <raylib.h>
+#include <raylib-cpp.hpp>
+
+#include "render/maze_view.hpp"
+
+MazeView::MazeView(Maze* maze, ray::Vector2 position) {
+	this->maze = maze;
+	this->position = position;
+}
+
+MazeView::~MazeView() {
+
+}
+
+float MazeView::CellSize() {
+	return MAZE_VIEW_SIZE / std::max(maze->Rows(), maze->Cols());
+}
+
+bool MazeView::Contains(Vector2 pos) {
+	return !(pos.x < position.x
+		|| pos.x > position.x + maze->Cols() * CellSize()
+		|| pos.y < position.y
+		|| pos.y > position.y + maze->Rows() * CellSize());
+}
+
+Point MazeView::ClosestCornerTo(Vector2 pos) {
+	if (!Contains(pos)) {
+		return Point(-1);
+	}
+
+	float cell_size = CellSize();
+	return Point(
+		(pos.x - position.x + cell_size / 2.0f) / cell_size,
+		(pos.y - position.y + cell_size / 2.0f) / cell_size
+	);
+}
+
+ray::Vector2 MazeView::CornerToPos(Point coord) {
+	return ray::Vector2(
+		position.x + coord.x * CellSize(),
+		position.y + coord.y * CellSize()
+	);
+}
+
+ray::Vector2 MazeView::CellToPos(Point coord) {
+	return CornerToPos(coord) + ray::Vector2(0.5f, 0.5f) * CellSize();
+}
+
+int MazeView::PixelWidth() {
+	return (int)ceilf(maze->Cols() * CellSize()) + 1;
+}
+
+int MazeView::PixelHeight() {
+	return (int)ceilf(maze->Rows() * CellSize()) + 1;
+}
+
+// Draw the walls in white, with the top left corner of the maze at origin
+void MazeView::DrawWalls(ray::Vector2 origin, float cell_size) {
+	for (int row = 0; row < maze->Rows(); row++) {
+		for (int col = 0; col < maze->Cols(); col++) {
+			ray::Vector2 pos = origin + ray::Vector2(col, row) * cell_size;
+			if (maze->WallAt(false, Point(col, row))) {
+				DrawLineV(pos, pos + ray::Vector2(0.0f, cell_size), WHITE);
+			}
+			if (maze->WallAt(true, Point(col, row))) {
+				DrawLineV(pos, pos + ray::Vector2(cell_size, 0.0f), WHITE);
+			}
+		}
+	}
+
+	// Draw the bottom and right edges of the maze
+	ray::Vector2 edge = origin + ray::Vector2(maze->Cols(), maze->Rows()) * cell_size;
+	DrawLine(edge.x, origin.y, edge.x, edge.y, WHITE);
+	DrawLine(origin.x, edge.y, edge.x, edge.y, WHITE);
+}
+
+// Draw the corners in white, with the top left corner of the maze at origin
+void MazeView::DrawCorners(ray::Vector2 origin, float cell_size) {
+	for (int row = 0; row <= maze->Rows(); row++) {
+		for (int col = 0; col <= maze->Cols(); col++) {
+			DrawCircleV(origin + ray::Vector2(col, row) * cell_size, 3.0f, WHITE);
+		}
+	}
+}
+
+void MazeView::Draw(Color wall_clr, Color dot_clr) {
+	if (baked_maze_version != maze->Version()) {
+		walls_layer.Invalidate();
+		corners_layer.Invalidate();
+		baked_maze_version = maze->Version();
+	}
+
+	float cell_size = CellSize();
+	if (walls_layer.Begin(PixelWidth(), PixelHeight())) {
+		DrawWalls(walls_layer.Origin(), cell_size);
+		walls_layer.End();
+	}
+	if (corners_layer.Begin(PixelWidth(), PixelHeight())) {
+		DrawCorners(corners_layer.Origin(), cell_size);
+		corners_layer.End();
+	}
+
+	// Layers are baked in white, so they can be drawn in any color
+	walls_layer.Draw(position, wall_clr);
+	corners_layer.Draw(position, dot_clr);
+}
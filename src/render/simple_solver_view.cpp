@@ -0,0 +1,117 @@
+#include <raylib.h>
+#include <raygui.h>
+
+#include "render/simple_solver_view.hpp"
+
+SimpleSolverView::SimpleSolverView(SimpleSolver* solver, MazeView* maze_view) {
+	this->solver = solver;
+	this->maze_view = maze_view;
+}
+
+SimpleSolverView::~SimpleSolverView() { }
+
+void SimpleSolverView::DrawPath(const std::vector<Point>& path, Color clr) {
+	ray::Vector2 from = maze_view->CellToPos(solver->coord);
+	for (int i = (int)path.size() - 1; i >= 0; i--) {
+		ray::Vector2 to = maze_view->CellToPos(path[i]);
+		DrawLineEx(from, to, 3.0f, clr);
+		from = to;
+	}
+}
+
+// Draw the known walls in white, with the top left corner of the maze at origin
+void SimpleSolverView::DrawKnownWalls(ray::Vector2 origin, float cell_size) {
+	// Draw known horizontal walls
+	for (int r = 0; r <= solver->rows; r++) {
+		for (int c = 0; c < solver->cols; c++) {
+			if (!solver->known_h_walls[r][c]) continue;
+			ray::Vector2 from = origin + ray::Vector2(c * cell_size, r * cell_size);
+			DrawLineV(from, from + ray::Vector2(cell_size, 0.0f), WHITE);
+		}
+	}
+	// Draw known vertical walls
+	for (int r = 0; r < solver->rows; r++) {
+		for (int c = 0; c <= solver->cols; c++) {
+			if (!solver->known_v_walls[r][c]) continue;
+			ray::Vector2 from = origin + ray::Vector2(c * cell_size, r * cell_size);
+			DrawLineV(from, from + ray::Vector2(0.0f, cell_size), WHITE);
+		}
+	}
+}
+
+void SimpleSolverView::Draw(bool show_floodfill_vals, Font floodfill_font) {
+	float cell_size = maze_view->CellSize();
+
+	if (baked_walls_version != solver->known_walls_version || baked_cell_size != cell_size) {
+		known_walls_layer.Invalidate();
+		baked_walls_version = solver->known_walls_version;
+		baked_cell_size = cell_size;
+	}
+	if (known_walls_layer.Begin(maze_view->PixelWidth(), maze_view->PixelHeight())) {
+		DrawKnownWalls(known_walls_layer.Origin(), cell_size);
+		known_walls_layer.End();
+	}
+	known_walls_layer.Draw(maze_view->position, BLACK);
+
+	DrawCircleV(maze_view->CellToPos(solver->coord), cell_size * 0.4f, ORANGE);
+
+	for (int i = 0; i < solver->rows; i++) {
+		Vector2 p = maze_view->CornerToPos(Point(-1, i));
+		GuiLabel(ray::Rectangle(p.x + 10.0f, p.y, 50.0f, 50.0f), std::to_string(i).c_str());
+	}
+	for (int i = 0; i < solver->cols; i++) {
+		Vector2 p = maze_view->CornerToPos(Point(i, solver->rows));
+		GuiLabel(ray::Rectangle(p.x + 10.0f, p.y, 50.0f, 50.0f), std::to_string(i).c_str());
+	}
+
+	if (solver->UpdateFinishedPaths()) {
+		DrawPath(solver->solution_path, DARKBLUE);
+		DrawPath(solver->alternative_path, BLACK);
+	} else {
+		DrawPath(solver->path, DARKBLUE);
+	}
+
+	for (Point& t : solver->target_coords) {
+		DrawCircleLinesV(maze_view->CellToPos(t), cell_size * 0.4f, BLACK);
+	}
+
+	if (!show_floodfill_vals || cell_size < FLOODFILL_MIN_CELL_SIZE) return;
+
+	if (baked_floodfill_version != solver->floodfill_version || baked_floodfill_cell_size != cell_size) {
+		floodfill_layer.Invalidate();
+		baked_floodfill_version = solver->floodfill_version;
+		baked_floodfill_cell_size = cell_size;
+	}
+	if (floodfill_layer.Begin(maze_view->PixelWidth(), maze_view->PixelHeight())) {
+		DrawFloodfillValues(floodfill_layer.Origin(), cell_size, floodfill_font);
+		floodfill_layer.End();
+	}
+	floodfill_layer.Draw(maze_view->position, WHITE);
+}
+
+// Draw the distance of each cell from the targets, with the top left corner of the maze at origin
+void SimpleSolverView::DrawFloodfillValues(ray::Vector2 origin, float cell_size, Font floodfill_font) {
+	const int TEXT_HEIGHT = 15;
+	int default_text_size = GuiGetStyle(DEFAULT, TEXT_SIZE);
+	int default_text_clr  = GuiGetStyle(DEFAULT, TEXT_COLOR_NORMAL);
+
+	GuiSetFont(floodfill_font);
+	GuiSetStyle(DEFAULT, TEXT_SIZE, TEXT_HEIGHT);
+	GuiSetStyle(DEFAULT, TEXT_COLOR_NORMAL, ColorToInt(DARKBLUE));
+
+	for (int r = 0; r < solver->rows; r++) {
+		for (int c = 0; c < solver->cols; c++) {
+			if (solver->ff_vals[r][c] == SIMPLE_FF_UNSET) continue;
+			char buffer[16];
+			snprintf(buffer, sizeof(buffer), "%u", solver->ff_vals[r][c]);
+			ray::Vector2 cell_pos = origin + ray::Vector2(c + 0.5f, r + 0.5f) * cell_size;
+			float x = cell_pos.x - GuiGetTextWidth(buffer) / 2.0f;
+			float y = cell_pos.y - TEXT_HEIGHT / 2.0f;
+			GuiLabel(ray::Rectangle(x, y, 50.0f, (float)TEXT_HEIGHT), buffer);
+		}
+	}
+
+	GuiSetFont(GetFontDefault());
+	GuiSetStyle(DEFAULT, TEXT_SIZE, default_text_size);
+	GuiSetStyle(DEFAULT, TEXT_COLOR_NORMAL, default_text_clr);
+}
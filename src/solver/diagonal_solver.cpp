@@ -1,18 +1,62 @@
 #include <algorithm>
-#include <raylib.h>
-#include <raygui.h>
-#include <queue>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
 
 #include "solver/diagonal_solver.hpp"
+#include "solver/maze_dims.hpp"
 #include "direction.hpp"
 #include "maze.hpp"
 
-#define FOREACH_EDGE(code) \
-	for (int row = 0; row <= MAZE_ROWS; row++) {\
-		for (int col = 0; col <= MAZE_COLS; col++) {\
+// Popped floodfill queue entries are dropped once there are at least this many
+#define FLOOD_QUEUE_COMPACT_MIN 4096
+
+// Upper bound for the floodfill queue entries allocated up front, for large mazes
+#define FLOOD_QUEUE_RESERVE_MAX (1 << 20)
+
+// Fast run planner states per edge: 6 headings can leave an edge (3 each way across it),
+// at the speed limit of a standing start or of any of the turns
+#define PLAN_HEADING_SLOTS 6
+#define PLAN_SPEED_SLOTS (MOTION_TURN_COUNT + 1)
+
+// Compass headings of fast run moves, clockwise from up, as steps in half cells. The planner places
+// horizontal edge (x, y) at (2x + 1, 2y), vertical edge (x, y) at (2x, 2y + 1) and cell (x, y) at (2x + 1, 2y + 1),
+// so moves along the walls are 2 long and diagonal moves 1 long on each axis.
+#define HEADING_COUNT 8
+static const int heading_dx[HEADING_COUNT] = { 0, 1, 2, 1, 0, -1, -2, -1 };
+static const int heading_dy[HEADING_COUNT] = { -2, -1, 0, 1, 2, 1, 0, -1 };
+
+// The turn primitives as the planner takes them, from the point where the straight before them ends:
+// the diagonal moves they take across cells and the heading they leave at, in 45 degree steps from the
+// heading of the straight (clockwise for right turns)
+struct PlanTurnShape {
+	MotionPrimitiveType type;
+	bool from_diagonal;
+	int move_count;
+	int moves[2];
+	int heading;
+};
+#define PLAN_TURN_COUNT 7
+static const PlanTurnShape plan_turn_shapes[PLAN_TURN_COUNT] = {
+	{ PRIMITIVE_S45_IN, false, 0, { 0, 0 }, 1 },
+	{ PRIMITIVE_S90, false, 1, { 1, 0 }, 2 },
+	{ PRIMITIVE_S135_IN, false, 1, { 1, 0 }, 3 },
+	{ PRIMITIVE_S180, false, 2, { 1, 3 }, 4 },
+	{ PRIMITIVE_S45_OUT, true, 0, { 0, 0 }, 1 },
+	{ PRIMITIVE_V90, true, 0, { 0, 0 }, 2 },
+	{ PRIMITIVE_S135_OUT, true, 1, { 2, 0 }, 3 }
+};
+
+// Runs code for each edge, with dims being the MazeDims to loop over. index is the edge's index
+// into the row-major edge grids.
+#define FOREACH_EDGE(dims, code) \
+	for (int row = 0; row <= (dims).Rows(); row++) {\
+		for (int col = 0; col <= (dims).Cols(); col++) {\
+			int index = row * ((dims).Cols() + 1) + col;\
 			for (int horizontal = 0; horizontal < 2; horizontal++)\
 			{\
-				Edge& edge = edges[horizontal][row][col];\
+				Edge& edge = edges[horizontal][0][index];\
 				code\
 			}\
 		}\
@@ -44,40 +88,139 @@ bool DiagonalSolver::FindSurroundingWalls() {
 
 	if (!upper_edge.visited && maze->WallAt(true, coord)) {
 		upper_edge.wall_exists = true;
+		walls_hash ^= ZobristKey(ZOBRIST_WALL, EdgeIndex(true, coord));
 		new_wall_discovered = true;
 	}
 	if (!lower_edge.visited && maze->WallAt(true, coord + Point(0, 1))) {
 		lower_edge.wall_exists = true;
+		walls_hash ^= ZobristKey(ZOBRIST_WALL, EdgeIndex(true, coord + Point(0, 1)));
 		new_wall_discovered = true;
 	}
 	if (!left_edge.visited && maze->WallAt(false, coord)) {
 		left_edge.wall_exists = true;
+		walls_hash ^= ZobristKey(ZOBRIST_WALL, EdgeIndex(false, coord));
 		new_wall_discovered = true;
 	}
 	if (!right_edge.visited && maze->WallAt(false, coord + Point(1, 0))) {
 		right_edge.wall_exists = true;
+		walls_hash ^= ZobristKey(ZOBRIST_WALL, EdgeIndex(false, coord + Point(1, 0)));
 		new_wall_discovered = true;
 	}
 
+	// Keep track of the edges that changed since the last floodfill
+	bool horizontals[4];
+	Point edge_coords[4];
+	GetEdgesOfCell(horizontals, edge_coords, coord);
+	for (int i = 0; i < 4; i++) {
+		if (!edges[horizontals[i]][edge_coords[i].y][edge_coords[i].x].visited) {
+			visited_hash ^= ZobristKey(ZOBRIST_VISITED, EdgeIndex(horizontals[i], edge_coords[i]));
+			changed_edges.push_back(PathNode(horizontals[i], edge_coords[i]));
+			if (goal_flood_ready) {
+				goal_flood.changed_edges.push_back(PathNode(horizontals[i], edge_coords[i]));
+			}
+		}
+	}
+
 	upper_edge.visited = true;
 	lower_edge.visited = true;
 	left_edge.visited = true;
 	right_edge.visited = true;
 
+	if (new_wall_discovered) {
+		known_walls_version++;
+	}
 	return new_wall_discovered;
 }
 
-// For a diagonal solver, flood starts from player
+// For a diagonal solver, flood starts from player.
+// The floodfill is always computed from scratch: edges are overwritten by any later push in the same
+// direction, so the values depend on the queue order and can't be repaired edge by edge.
 void DiagonalSolver::Floodfill(bool visited_edges_only) {
-	// Reset floodfill values and directions
-	FOREACH_EDGE(
+	Floodfill(visited_edges_only, FLOODFILL_OTHER);
+}
+
+void DiagonalSolver::Floodfill(bool visited_edges_only, FloodfillCause cause) {
+	floodfill_count++;
+	floodfill_version++;
+	stats.floodfills[cause]++;
+
+	// The same known walls and starting cell always flood the same way
+	bool cached = cache_floodfills && (size_t)rows * cols <= FLOOD_CACHE_MAX_CELLS;
+	uint64_t key = cached ? FloodKey(visited_edges_only) : 0;
+	DiagonalFloodResult* result = cached ? flood_cache.Find(key) : nullptr;
+	if (result) {
+		stats.flood_cache_hits++;
+		MazeDims<0, 0> dims = { rows, cols };
+		FOREACH_EDGE(dims,
+			const Edge& cached_edge = result->edges[horizontal][0][index];
+			edge.ff_val = cached_edge.ff_val;
+			edge.same_dir = cached_edge.same_dir;
+			edge.dir = cached_edge.dir;
+		);
+		flood_valid = true;
+		flood_coord = coord;
+		flood_visited_edges_only = visited_edges_only;
+		changed_edges.clear();
+		path = result->path;
+		stats.AddPath(path.size());
+		return;
+	}
+	if (cached) {
+		stats.flood_cache_misses++;
+	}
+
+	(this->*run_flood)(visited_edges_only);
+	changed_edges.clear();
+
+	UpdatePath();
+	if (cached) {
+		DiagonalFloodResult& stored = flood_cache.Insert(key);
+		stored.edges[0] = edges[0];
+		stored.edges[1] = edges[1];
+		stored.path = path;
+	}
+}
+
+// Index of an edge among both edge grids, horizontal ones last
+int DiagonalSolver::EdgeIndex(bool horizontal, Point edge_coord) {
+	return (horizontal * (rows + 1) + edge_coord.y) * (cols + 1) + edge_coord.x;
+}
+
+// Hash of everything a floodfill reads: the known walls, the visited edges when only they are flooded,
+// the cell it floods from, and the targets the path is traced to
+uint64_t DiagonalSolver::FloodKey(bool visited_edges_only) {
+	uint64_t key = walls_hash ^ ZobristKey(ZOBRIST_COORD, coord.y * cols + coord.x);
+	if (visited_edges_only) {
+		key ^= visited_hash ^ ZobristKey(ZOBRIST_VISITED_ONLY, 0);
+	}
+	for (size_t i = 0; i < target_coords.size(); i++) {
+		const Point& t = target_coords[i];
+		key ^= ZobristKey(ZOBRIST_TARGET, (uint64_t)i << 32 | (uint32_t)(t.y * cols + t.x));
+	}
+	return key;
+}
+
+template <int ROWS, int COLS>
+void DiagonalSolver::RunFlood(bool visited_edges_only) {
+	StartFlood<ROWS, COLS>(visited_edges_only);
+	ContinueFlood<ROWS, COLS>();
+}
+
+// Clear the floodfill values and populate the queue with the edges of the current cell
+template <int ROWS, int COLS>
+void DiagonalSolver::StartFlood(bool visited_edges_only) {
+	MazeDims<ROWS, COLS> dims = { rows, cols };
+	FOREACH_EDGE(dims,
 		edge.ff_val = FF_VAL_FROM_FLOAT(-1.0f);
 		edge.same_dir = 0;
 		edge.dir = DIR_UNKNOWN;
 	);
 
-	// Populate queue with edges of current cell
-	std::queue<PathNode> q;
+	flood_valid = true;
+	flood_coord = coord;
+	flood_visited_edges_only = visited_edges_only;
+	flood_queue.clear();
+
 	bool horizontals[4];
 	Point edge_coords[4];
 	GetEdgesOfCell(horizontals, edge_coords, coord);
@@ -88,21 +231,43 @@ void DiagonalSolver::Floodfill(bool visited_edges_only) {
 		if (!edge.wall_exists) {
 			edge.ff_val = FF_VAL_FROM_FLOAT(0.0f);
 			edge.dir = (Direction)(1 + 3 * i);
-			q.push(PathNode(h, e));
+			flood_queue.push_back(PathNode(h, e));
+			stats.queue_pushes++;
 		}
 	}
+}
+
+// Process the queue until it is empty
+template <int ROWS, int COLS>
+void DiagonalSolver::ContinueFlood() {
+	MazeDims<ROWS, COLS> dims = { rows, cols };
+	Edge* edge_grids[2] = { edges[0][0], edges[1][0] };
+	size_t head = 0;
+	bool horizontals[3];
+	Point edge_coords[3];
+	long long pushes = 0;
+	long long pops = 0;
+	long long expanded = 0;
+
+	while (head < flood_queue.size()) {
+		// Drop the popped entries once they make up most of the queue
+		if (head >= FLOOD_QUEUE_COMPACT_MIN && head * 2 >= flood_queue.size()) {
+			flood_queue.erase(flood_queue.begin(), flood_queue.begin() + head);
+			head = 0;
+		}
 
-	while (!q.empty()) {
-		bool horizontal = q.front().horizontal;
-		Point edge_coord = q.front().edge_coord;
-		q.pop();
+		bool horizontal = flood_queue[head].horizontal;
+		Point edge_coord = flood_queue[head].edge_coord;
+		head++;
+		pops++;
 
 		// Prioritize making edges that share a common direction
 		int common_test_dir_i = 0;
 		while (common_test_dir_i != -1) {
 			common_test_dir_i = -1;
+			expanded++;
 
-			Edge edge = edges[horizontal][edge_coord.y][edge_coord.x];
+			Edge edge = edge_grids[horizontal][dims.Edge(edge_coord)];
 			Direction normalized_dir = NormalizeDir(edge.dir);
 
 			// Find the other 3 edges of the cell to evaluate, based on the direction
@@ -110,15 +275,15 @@ void DiagonalSolver::Floodfill(bool visited_edges_only) {
 			for (int i = 0; i < 3; i++) {
 				Direction new_dir = (Direction)(normalized_dir + i);
 				Point new_coord = edge_coord + edge_coords[i];
-				Edge& new_edge = edges[horizontals[i]][new_coord.y][new_coord.x];
+				Edge& new_edge = edge_grids[horizontals[i]][dims.Edge(new_coord)];
 
 				bool within_bounds = (normalized_dir == DIR_UP && new_coord.y >= 0)
-					|| (normalized_dir == DIR_DOWN && new_coord.y < MAZE_ROWS)
+					|| (normalized_dir == DIR_DOWN && new_coord.y < dims.Rows())
 					|| (normalized_dir == DIR_LEFT && new_coord.x >= 0)
-					|| (normalized_dir == DIR_RIGHT && new_coord.x < MAZE_COLS);
+					|| (normalized_dir == DIR_RIGHT && new_coord.x < dims.Cols());
 
 				if (within_bounds
-					&& (!visited_edges_only || (visited_edges_only && new_edge.visited))
+					&& (!flood_visited_edges_only || (flood_visited_edges_only && new_edge.visited))
 					&& !new_edge.wall_exists
 					&& (new_edge.ff_val < FF_VAL_FROM_FLOAT(0.0f)
 						|| edge.dir == NormalizeDir(new_edge.dir)
@@ -126,7 +291,8 @@ void DiagonalSolver::Floodfill(bool visited_edges_only) {
 					// Set edge values and push it to queue
 					new_edge.ff_val = edge.ff_val + (new_dir == normalized_dir ? 3 : 2);
 					new_edge.dir = new_dir;
-					q.push(PathNode(horizontals[i], new_coord));
+					flood_queue.push_back(PathNode(horizontals[i], new_coord));
+					pushes++;
 
 					// Keep track of edges that share a common direction
 					if (SimilarDirections(new_edge.dir, edge.dir)) {
@@ -144,32 +310,51 @@ void DiagonalSolver::Floodfill(bool visited_edges_only) {
 		}
 	}
 
-	UpdatePath();
+	stats.queue_pushes += pushes;
+	stats.queue_pops += pops;
+	stats.expansions += expanded;
 }
 
+// Trace the path along the current floodfill values
 void DiagonalSolver::UpdatePath() {
-	path = { };
+	(this->*trace_path)();
+	stats.AddPath(path.size());
+}
+
+template <int ROWS, int COLS>
+void DiagonalSolver::TracePath() {
+	MazeDims<ROWS, COLS> dims = { rows, cols };
+	const Edge* edge_grids[2] = { edges[0][0], edges[1][0] };
+
+	path.clear();
 
 	Point edge_coord;
 	bool horizontal;
 	Edge edge;
 
 	// Find starting edge
-	edge.ff_val = 0b1111111111;
+	edge.ff_val = UINT32_MAX;
+	bool found = false;
 	bool horizontals[4];
 	Point edge_coords[4];
-	for (int i = 0; i < target_coords.size(); i++) {
+	for (size_t i = 0; i < target_coords.size(); i++) {
 		GetEdgesOfCell(horizontals, edge_coords, target_coords[i]);
 		for (int i = 0; i < 4; i++) {
-			Edge new_edge = edges[horizontals[i]][edge_coords[i].y][edge_coords[i].x];
+			Edge new_edge = edge_grids[horizontals[i]][dims.Edge(edge_coords[i])];
 			if (new_edge.ff_val >= FF_VAL_FROM_FLOAT(0.0f) && new_edge.ff_val < edge.ff_val) {
 				edge_coord = edge_coords[i];
 				horizontal = horizontals[i];
 				edge = new_edge;
+				found = true;
 			}
 		}
 	}
 
+	// No target is reachable with the current floodfill values
+	if (!found) {
+		return;
+	}
+
 	// Keep going until there are no more edges to go to
 	bool moved = true;
 	while (moved) {
@@ -194,13 +379,15 @@ void DiagonalSolver::UpdatePath() {
 				Point new_coord = from_edge_coord + edge_coords[i];
 
 				bool within_bounds = (normalized_dir == DIR_UP && new_coord.y >= 0)
-					|| (normalized_dir == DIR_DOWN && new_coord.y < MAZE_ROWS)
+					|| (normalized_dir == DIR_DOWN && new_coord.y < dims.Rows())
 					|| (normalized_dir == DIR_LEFT && new_coord.x >= 0)
-					|| (normalized_dir == DIR_RIGHT && new_coord.x < MAZE_COLS);
+					|| (normalized_dir == DIR_RIGHT && new_coord.x < dims.Cols());
+				if (!within_bounds) {
+					continue;
+				}
 
-				Edge new_edge = edges[horizontals[i]][new_coord.y][new_coord.x];
-				if (within_bounds
-					&& new_edge.ff_val >= FF_VAL_FROM_FLOAT(0.0f)
+				Edge new_edge = edge_grids[horizontals[i]][dims.Edge(new_coord)];
+				if (new_edge.ff_val >= FF_VAL_FROM_FLOAT(0.0f)
 					&& new_edge.ff_val < from_edge.ff_val
 					&& ((j == 0 && SimilarDirections(from_edge.dir, new_edge.dir))
 						|| (j == 1 && new_edge.ff_val < edge.ff_val))) {
@@ -216,28 +403,69 @@ void DiagonalSolver::UpdatePath() {
 
 // Get the necessary coordinates to visit to validate a potentially better solution path
 void DiagonalSolver::UpdateTargetCoords() {
+	stats.target_updates++;
 	std::vector<Point> unvisited_coords = { };
 
-	Point tmp_coord = coord;
-
-	coord = starting_coord;
-	target_coords = maze->goals;
-	Floodfill(false);
-	for (int i = 0; i < path.size(); i++) {
-		bool horizontal = path[i].horizontal;
-		Point edge_coord = path[i].edge_coord;
+	if (astar_target_paths) {
+		FindPath(starting_coord, maze->goals, false, goal_flood.path);
+	} else {
+		UpdateGoalFlood();
+	}
+	for (size_t i = 0; i < goal_flood.path.size(); i++) {
+		bool horizontal = goal_flood.path[i].horizontal;
+		Point edge_coord = goal_flood.path[i].edge_coord;
 		if (!edges[horizontal][edge_coord.y][edge_coord.x].visited) {
 			unvisited_coords.push_back(edge_coord);
 		}
 	}
 
-	coord = tmp_coord;
 	target_coords = unvisited_coords;
 	if (target_coords.size() == 0) {
 		target_coords = { starting_coord };
 	}
 }
 
+// Bring the floodfill from the starting cell up to date with the walls found since it last ran, and trace
+// the path from it to the goals into goal_flood.path. The navigation floodfill is swapped out meanwhile,
+// so it is left as it was.
+void DiagonalSolver::UpdateGoalFlood() {
+	if (!goal_flood_ready) {
+		for (int horizontal = 0; horizontal < 2; horizontal++) {
+			goal_flood.edges[horizontal] = edges[horizontal];
+		}
+		goal_flood.valid = false;
+		goal_flood.changed_edges.clear();
+		goal_flood_ready = true;
+	} else {
+		for (PathNode& node : goal_flood.changed_edges) {
+			const Edge& edge = edges[node.horizontal][node.edge_coord.y][node.edge_coord.x];
+			Edge& goal_edge = goal_flood.edges[node.horizontal][node.edge_coord.y][node.edge_coord.x];
+			goal_edge.wall_exists = edge.wall_exists;
+			goal_edge.visited = edge.visited;
+		}
+	}
+
+	SwapFlood(goal_flood);
+	Point tmp_coord = coord;
+	coord = starting_coord;
+	target_coords = maze->goals;
+	Floodfill(false, FLOODFILL_TARGET_CHANGE);
+	coord = tmp_coord;
+	SwapFlood(goal_flood);
+}
+
+// Exchange the current floodfill with the one in state
+void DiagonalSolver::SwapFlood(DiagonalFloodState& state) {
+	for (int horizontal = 0; horizontal < 2; horizontal++) {
+		std::swap(edges[horizontal], state.edges[horizontal]);
+	}
+	std::swap(flood_valid, state.valid);
+	std::swap(flood_coord, state.coord);
+	std::swap(flood_visited_edges_only, state.visited_edges_only);
+	std::swap(changed_edges, state.changed_edges);
+	std::swap(path, state.path);
+}
+
 DiagonalSolver::DiagonalSolver(Maze* maze, Point starting_coord) {
 	this->maze = maze;
 	this->starting_coord = starting_coord;
@@ -248,11 +476,56 @@ DiagonalSolver::~DiagonalSolver() {
 
 }
 
+// Size the solver's storage for a rows x cols maze.
+// The floodfill queues and path buffers are allocated up front, so floodfills don't have to.
+void DiagonalSolver::Resize(int rows, int cols) {
+	this->rows = rows;
+	this->cols = cols;
+
+	for (int horizontal = 0; horizontal < 2; horizontal++) {
+		edges[horizontal].Resize(rows + 1, cols + 1);
+	}
+
+	size_t edge_count = 2 * (size_t)(rows + 1) * (cols + 1);
+	flood_queue.reserve(std::min(FLOOD_QUEUE_RESERVE_PER_EDGE * edge_count, (size_t)FLOOD_QUEUE_RESERVE_MAX));
+	changed_edges.reserve(edge_count);
+	path.reserve(edge_count);
+	goal_flood.changed_edges.reserve(edge_count);
+	goal_flood.path.reserve(edge_count);
+	flood_cache.Clear();
+	search_costs.reserve(edge_count);
+	search_parents.reserve(edge_count);
+	search_heap.reserve(4 * edge_count);
+}
+
+template <int ROWS, int COLS>
+void DiagonalSolver::UseSizedCode() {
+	run_flood = &DiagonalSolver::RunFlood<ROWS, COLS>;
+	trace_path = &DiagonalSolver::TracePath<ROWS, COLS>;
+}
+
+// Standard competition sizes get code specialized for their size, others the generic code
+void DiagonalSolver::SelectSizedCode() {
+	if (rows == 16 && cols == 16) {
+		UseSizedCode<16, 16>();
+	} else if (rows == 32 && cols == 32) {
+		UseSizedCode<32, 32>();
+	} else {
+		UseSizedCode<0, 0>();
+	}
+}
+
 // Reset the conditions to where the solver does not know anything about the maze
 void DiagonalSolver::Reset() {
-	FOREACH_EDGE(
-		bool is_a_border_wall = ((horizontal && col < MAZE_COLS && (row == 0 || row == MAZE_ROWS))
-			|| (!horizontal && row < MAZE_ROWS && (col == 0 || col == MAZE_COLS)));
+	if (rows != maze->Rows() || cols != maze->Cols()) {
+		Resize(maze->Rows(), maze->Cols());
+		SelectSizedCode();
+	}
+
+	MazeDims<0, 0> dims = { rows, cols };
+	FOREACH_EDGE(dims,
+		bool is_a_border_wall = ((horizontal && col < cols && (row == 0 || row == rows))
+			|| (!horizontal && row < rows && (col == 0 || col == cols)));
 
 		edge.ff_val = FF_VAL_FROM_FLOAT(-1.0f);
 		edge.same_dir = 0;
@@ -261,23 +534,37 @@ void DiagonalSolver::Reset() {
 		edge.wall_exists = is_a_border_wall;
 	);
 	run_number = 0;
+	floodfill_count = 0;
+	known_walls_version++;
+	flood_valid = false;
+	changed_edges.clear();
+	goal_flood_ready = false;
+	walls_hash = 0;
+	visited_hash = 0;
 
 	SoftReset();
 }
 
 // Get ready for another run, without clearing the solver's knowledge of the maze
 void DiagonalSolver::SoftReset() {
+	stats = SolverStats();
 	coord = starting_coord;
 	target_coords = maze->goals;
 	finished = false;
+	finished_paths_valid = false;
 	going_back = false;
 	run_number++;
 
 	FindSurroundingWalls();
-	Floodfill(run_number != 1);
+	Floodfill(run_number != 1, FLOODFILL_RUN_START);
 }
 
 void DiagonalSolver::Step() {
+	StepTimer timer(stats);
+	if (path.empty()) {
+		return;
+	}
+
 	bool horizontal = path.back().horizontal;
 	Point edge_coord = path.back().edge_coord;
 	path.pop_back();
@@ -288,7 +575,7 @@ void DiagonalSolver::Step() {
 		if (going_back) {
 			UpdateTargetCoords();
 		}
-		Floodfill(false);
+		Floodfill(false, FLOODFILL_NEW_WALLS);
 	}
 
 	// If a target coordinate is reached
@@ -317,137 +604,482 @@ void DiagonalSolver::Step() {
 		}
 
 		// Floodfill values need to be recalculated after target_coords is updated
-		Floodfill(false);
+		Floodfill(false, FLOODFILL_TARGET_CHANGE);
 	}
 }
 
-bool DiagonalSolver::IsFinished() {
-	return finished;
+bool DiagonalSolver::UpdateFinishedPaths() {
+	if (!finished) {
+		return false;
+	}
+	if (finished_paths_valid && finished_paths_maze_version == maze->Version()) {
+		return true;
+	}
+
+	Floodfill(true);
+	solution_path = path;
+	Floodfill(false);
+	alternative_path = path;
+	solution_path_time = EstimateRunTime(solution_path, coord);
+	fast_path_time = PlanFastRun(true, fast_path);
+
+	finished_paths_valid = true;
+	finished_paths_maze_version = maze->Version();
+	return true;
 }
 
-void DiagonalSolver::DrawPath(Color clr) {
-	ray::Vector2 from = maze->CellToPos(coord);
-	for (int i = path.size() - 1; i >= 0; i--) {
-		bool horizontal = path[i].horizontal;
-		Point edge_coord = path[i].edge_coord;
-		ray::Vector2 to = maze->CornerToPos(edge_coord) + (horizontal
-			? ray::Vector2(MAZE_CELL_SIZE / 2.0f, 0.0f)
-			: ray::Vector2(0.0f, MAZE_CELL_SIZE / 2.0f));
+static int Sign(int x) {
+	return (x > 0) - (x < 0);
+}
 
-		DrawLineEx(from, to, 3.0f, clr);
-		from = to;
-	}
+static int HeadingSlot(int heading) {
+	return heading & 1 ? heading >> 1 : 4 + (heading >> 2);
 }
 
-void DiagonalSolver::Draw(ray::Vector2 pos, bool show_floodfill_vals, Font floodfill_font) {
-	// Draw known walls
-	FOREACH_EDGE(
-		if (edge.wall_exists) {
-			ray::Vector2 from = pos + ray::Vector2(col, row) * MAZE_CELL_SIZE;
-			ray::Vector2 to = from + (horizontal
-				? ray::Vector2(MAZE_CELL_SIZE, 0.0f)
-				: ray::Vector2(0.0f, MAZE_CELL_SIZE));
-			DrawLineV(from, to, BLACK);
-		}
-	);
+// Heading of a move by (dx, dy) half cells
+static int HeadingOf(int dx, int dy) {
+	static const int headings[3][3] = {
+		{ 7, 6, 5 }, // dx < 0, by dy < 0, == 0, > 0
+		{ 0, -1, 4 },
+		{ 1, 2, 3 }
+	};
+	return headings[Sign(dx) + 1][Sign(dy) + 1];
+}
 
-	// Draw current coord
-	DrawCircleV(maze->CellToPos(coord), MAZE_CELL_SIZE * 0.4f, ORANGE);
+// Heap order of the planner states, earliest first
+static bool PlanLater(const FastRunEntry& a, const FastRunEntry& b) {
+	return a.time > b.time;
+}
 
-	// Show row and column labels
-	for (int i = 0; i < MAZE_ROWS; i++) {
-		Vector2 p = maze->CornerToPos(Point(-1, i));
-		GuiLabel(
-			ray::Rectangle(p.x + 10.0f, p.y, 50.0f, 50.0f),
-			std::to_string(i).c_str()
-		);
+static PathNode PlanNode(int x, int y) {
+	return PathNode(!(y & 1), Point(x >> 1, y >> 1));
+}
+
+// Move from the edge at (x, y) to the next edge in heading, if the move crosses a cell and the
+// edge it reaches can be driven through
+bool DiagonalSolver::PlanMove(int* x, int* y, int heading, bool visited_edges_only) {
+	int dx = heading_dx[heading];
+	int dy = heading_dy[heading];
+
+	// Cell passed through, which moves along a wall miss
+	int cell_x = *x + dx / 2;
+	int cell_y = *y + dy / 2;
+	if (heading & 1) {
+		cell_x = *y & 1 ? *x + dx : *x;
+		cell_y = *y & 1 ? *y : *y + dy;
 	}
-	for (int i = 0; i < MAZE_COLS; i++) {
-		Vector2 p = maze->CornerToPos(Point(i, MAZE_ROWS));
-		GuiLabel(
-			ray::Rectangle(p.x + 10.0f, p.y, 50.0f, 50.0f),
-			std::to_string(i).c_str()
-		);
+	if (!(cell_x & 1) || !(cell_y & 1)) {
+		return false;
+	}
+	cell_x >>= 1;
+	cell_y >>= 1;
+	if (cell_x < 0 || cell_y < 0 || cell_x >= cols || cell_y >= rows) {
+		return false;
+	}
+
+	int next_x = *x + dx;
+	int next_y = *y + dy;
+	const Edge& edge = edges[!(next_y & 1)][next_y >> 1][next_x >> 1];
+	if (edge.wall_exists || (visited_edges_only && !edge.visited)) {
+		return false;
+	}
+
+	*x = next_x;
+	*y = next_y;
+	return true;
+}
+
+int DiagonalSolver::PlanState(int x, int y, int heading, int speed_slot) {
+	int edge = (!(y & 1) * (rows + 1) + (y >> 1)) * (cols + 1) + (x >> 1);
+	return (edge * PLAN_HEADING_SLOTS + HeadingSlot(heading)) * PLAN_SPEED_SLOTS + speed_slot;
+}
+
+// Position of a planner state's edge, and the heading of its straight (returned)
+int DiagonalSolver::PlanPosition(int state, int* x, int* y) {
+	int heading_slot = state / PLAN_SPEED_SLOTS % PLAN_HEADING_SLOTS;
+	int edge = state / (PLAN_SPEED_SLOTS * PLAN_HEADING_SLOTS);
+	int edge_row = edge / (cols + 1);
+	bool horizontal = edge_row > rows;
+	edge_row -= horizontal ? rows + 1 : 0;
+
+	*x = 2 * (edge % (cols + 1)) + horizontal;
+	*y = 2 * edge_row + !horizontal;
+	return heading_slot < 4 ? 2 * heading_slot + 1 : (horizontal ? 0 : 2) + (heading_slot - 4) * 4;
+}
+
+void DiagonalSolver::PlanRelax(int state, float time, const FastRunLink& link) {
+	if (time < plan_times[state]) {
+		plan_times[state] = time;
+		plan_links[state] = link;
+		plan_heap.push_back({ time, state });
+		std::push_heap(plan_heap.begin(), plan_heap.end(), PlanLater);
 	}
+}
 
-	if (finished) {
-		// Solution
-		Floodfill(true);
-		DrawPath(DARKBLUE);
+// Whether a move in heading can follow one in from_heading at the edge at half cell row y, crossing it the same way.
+// Only the row matters: horizontal edges are on even rows and crossed vertically, vertical edges on odd rows.
+static bool PlanCrosses(int y, int from_heading, int heading) {
+	return y & 1
+		? Sign(heading_dx[heading]) == Sign(heading_dx[from_heading])
+		: Sign(heading_dy[heading]) == Sign(heading_dy[from_heading]);
+}
 
-		// Alternative solution
-		Floodfill(false);
-		DrawPath(BLACK);
+// Expand the straights in heading from (x, y), the edge of planner state `state` (or the middle of the
+// starting cell for state -1), started at time with the speed limit of speed_slot. Each straight ends
+// at a goal or with a turn primitive into a new state.
+void DiagonalSolver::PlanStraights(int x, int y, int heading, int speed_slot, float time, int state, bool visited_edges_only) {
+	bool diagonal = heading & 1;
+	int entry_speed = speed_slot == 0 ? MOTION_SPEED_STOP : speed_slot - 1;
+	int units = 0;
+
+	if (state < 0) {
+		// Half a cell from the middle of the starting cell to its edge
+		x += heading_dx[heading] / 2;
+		y += heading_dy[heading] / 2;
+		const Edge& edge = edges[!(y & 1)][y >> 1][x >> 1];
+		if (edge.wall_exists || (visited_edges_only && !edge.visited)) {
+			return;
+		}
+		units = 1;
+	} else if (PlanMove(&x, &y, heading, visited_edges_only)) {
+		units = diagonal ? 1 : 2;
 	} else {
-		// Current path
-		DrawPath(DARKBLUE);
+		return;
 	}
 
-	// Show unvisited coords of a potentially better path
-	for (Point target : target_coords) {
-		DrawCircleLinesV(maze->CellToPos(target), MAZE_CELL_SIZE * 0.4f, BLACK);
+	while (true) {
+		// Stop in the goal, if the cell ahead is one
+		int ahead_x = (y & 1 ? x + Sign(heading_dx[heading]) : x) >> 1;
+		int ahead_y = (y & 1 ? y : y + Sign(heading_dy[heading])) >> 1;
+		if (ahead_x >= 0 && ahead_y >= 0 && ahead_x < cols && ahead_y < rows && plan_goals[ahead_y][ahead_x]) {
+			float goal_time = time + motion_model.StraightTime(diagonal, units, entry_speed, MOTION_SPEED_STOP);
+			PlanRelax((int)plan_times.size() - 1, goal_time, { state, x, y, PRIMITIVE_STRAIGHT, false });
+		}
+
+		// RunCompiler folds a single diagonal move into the turns on either side where it can, so the planner
+		// only keeps one where the compiler would: between a V90 or S135 in and a V90 or S135 out
+		bool single_diagonal = diagonal && units == 1;
+		for (int i = 0; i < PLAN_TURN_COUNT && !(single_diagonal && entry_speed == TURN_45); i++) {
+			const PlanTurnShape& turn = plan_turn_shapes[i];
+			if (turn.from_diagonal != diagonal || (single_diagonal && turn.type == PRIMITIVE_S45_OUT)) {
+				continue;
+			}
+
+			for (int side = -1; side <= 1; side += 2) {
+				// The diagonal moves of the turn, then the first move of the straight after it
+				int turn_x = x;
+				int turn_y = y;
+				int from_heading = heading;
+				bool possible = true;
+				for (int move = 0; move < turn.move_count && possible; move++) {
+					int move_heading = (heading + side * turn.moves[move] + HEADING_COUNT) % HEADING_COUNT;
+					possible = PlanCrosses(turn_y, from_heading, move_heading)
+						&& PlanMove(&turn_x, &turn_y, move_heading, visited_edges_only);
+					from_heading = move_heading;
+				}
+				int new_heading = (heading + side * turn.heading + HEADING_COUNT) % HEADING_COUNT;
+				int next_x = turn_x;
+				int next_y = turn_y;
+				if (!possible || !PlanCrosses(turn_y, from_heading, new_heading)
+					|| !PlanMove(&next_x, &next_y, new_heading, visited_edges_only)) {
+					continue;
+				}
+
+				int motion_turn = MotionModel::PrimitiveTurn(turn.type);
+				float turn_time = time + motion_model.StraightTime(diagonal, units, entry_speed, motion_turn)
+					+ motion_model.TurnPrimitiveTime(turn.type);
+				PlanRelax(PlanState(turn_x, turn_y, new_heading, motion_turn + 1), turn_time, { state, x, y, turn.type, side > 0 });
+			}
+		}
+
+		if (!PlanMove(&x, &y, heading, visited_edges_only)) {
+			break;
+		}
+		units += diagonal ? 1 : 2;
 	}
+}
 
-	// Show manhattan distance of each cell from the goal
-	if (!show_floodfill_vals) {
-		return;
+// Dijkstra's algorithm over the planner states. A state is left by a straight of any length and a turn
+// primitive, so the cost of each is its exact time under the motion model, from the speed limit it starts at
+// to the turn (or stop) it ends with, and a plan costs what MotionModel::RunTime() gives for its compiled run.
+float DiagonalSolver::PlanFastRun(bool visited_edges_only, std::vector<PathNode>& dest) {
+	dest.clear();
+	if (std::find(maze->goals.begin(), maze->goals.end(), starting_coord) != maze->goals.end()) {
+		return 0.0f;
 	}
 
-	const int TEXT_HEIGHT = 13;
-	int default_text_size = GuiGetStyle(DEFAULT, TEXT_SIZE);
-	int default_text_clr = GuiGetStyle(DEFAULT, TEXT_COLOR_NORMAL);
+	size_t state_count = 2 * (size_t)(rows + 1) * (cols + 1) * PLAN_HEADING_SLOTS * PLAN_SPEED_SLOTS;
+	if (state_count >= INT_MAX) {
+		return -1.0f;
+	}
+	plan_times.assign(state_count + 1, INFINITY); // The last one is reaching a goal
+	plan_links.resize(state_count + 1);
+	plan_heap.clear();
+	plan_goals.Resize(rows, cols);
+	for (Point& goal : maze->goals) {
+		if (goal.x >= 0 && goal.y >= 0 && goal.x < cols && goal.y < rows) {
+			plan_goals[goal.y][goal.x] = 1;
+		}
+	}
 
-	GuiSetFont(floodfill_font);
+	// Leave the starting cell along any of the walls, from a standing start
+	int start_x = 2 * starting_coord.x + 1;
+	int start_y = 2 * starting_coord.y + 1;
+	for (int heading = 0; heading < HEADING_COUNT; heading += 2) {
+		PlanStraights(start_x, start_y, heading, 0, 0.0f, -1, visited_edges_only);
+	}
 
-	for (int i = 0; i < MAZE_ROWS; i++) {
-		for (int j = 0; j < MAZE_COLS; j++) {
-			char buffer[16];
-			float x, y, ff_val_f;
-			Vector2 p = maze->CornerToPos(Point(j, i));
+	int goal_state = (int)state_count;
+	while (!plan_heap.empty()) {
+		std::pop_heap(plan_heap.begin(), plan_heap.end(), PlanLater);
+		FastRunEntry entry = plan_heap.back();
+		plan_heap.pop_back();
+		if (entry.time > plan_times[entry.state]) {
+			continue;
+		}
+		if (entry.state == goal_state) {
+			break;
+		}
 
-			// Horizontal floodfill values
-			if ((ff_val_f = FF_VAL_TO_FLOAT(edges[true][i][j].ff_val)) >= 0.0f) {
-				snprintf(
-					buffer,
-					sizeof(buffer),
-					"%.1f\n%s,%d",
-					ff_val_f,
-					DirToStr(edges[true][i][j].dir).c_str(),
-					edges[true][i][j].same_dir
-				);
+		int x, y;
+		int heading = PlanPosition(entry.state, &x, &y);
+		PlanStraights(x, y, heading, entry.state % PLAN_SPEED_SLOTS, entry.time, entry.state, visited_edges_only);
+	}
 
-				x = p.x + (MAZE_CELL_SIZE - GuiGetTextWidth(buffer)) / 2.0f;
-				y = p.y - TEXT_HEIGHT / 2.0f;
+	if (plan_times[goal_state] == INFINITY) {
+		return -1.0f;
+	}
 
-				GuiSetStyle(DEFAULT, TEXT_COLOR_NORMAL, ColorToInt(RED));
+	// Follow the links back from the goal, then lay out the run's waypoints from the start
+	plan_chain.clear();
+	for (int state = goal_state; state >= 0; state = plan_links[state].parent) {
+		plan_chain.push_back(state);
+	}
+	plan_waypoints.clear();
+	plan_waypoints.push_back({ start_x, start_y });
+	int x = start_x;
+	int y = start_y;
+	for (int i = (int)plan_chain.size() - 1; i >= 0; i--) {
+		const FastRunLink& link = plan_links[plan_chain[i]];
+		int heading;
+		if (link.parent < 0) {
+			// The first move is only half as long
+			heading = HeadingOf(link.turn_x - x, link.turn_y - y);
+			x += heading_dx[heading] / 2;
+			y += heading_dy[heading] / 2;
+			plan_waypoints.push_back({ x, y });
+		} else {
+			heading = PlanPosition(link.parent, &x, &y);
+		}
+		while (x != link.turn_x || y != link.turn_y) {
+			x += heading_dx[heading];
+			y += heading_dy[heading];
+			plan_waypoints.push_back({ x, y });
+		}
 
-				GuiSetStyle(DEFAULT, TEXT_SIZE, TEXT_HEIGHT);
-				GuiLabel(ray::Rectangle(x, y, 50.0f, TEXT_HEIGHT), buffer);
+		for (int j = 0; j < PLAN_TURN_COUNT; j++) {
+			const PlanTurnShape& turn = plan_turn_shapes[j];
+			if (turn.type != link.turn) {
+				continue;
 			}
+			for (int move = 0; move < turn.move_count; move++) {
+				int move_heading = (heading + (link.right ? 1 : -1) * turn.moves[move] + HEADING_COUNT) % HEADING_COUNT;
+				x += heading_dx[move_heading];
+				y += heading_dy[move_heading];
+				plan_waypoints.push_back({ x, y });
+			}
+		}
+	}
+
+	for (int i = (int)plan_waypoints.size() - 1; i > 0; i--) {
+		dest.push_back(PlanNode(plan_waypoints[i].x, plan_waypoints[i].y));
+	}
+	return plan_times[goal_state];
+}
+
+float DiagonalSolver::EstimateRunTime(const std::vector<PathNode>& path, Point start) {
+	EdgePathWaypoints(path, start, plan_waypoints);
+	if (!run_compiler.Compile(plan_waypoints, run_primitives)) {
+		return -1.0f;
+	}
+	return motion_model.RunTime(run_primitives);
+}
+
+// Floodfill cost from the edge at (x, y) to the closest edge of any of goals, which no path can beat:
+// every diagonal move (cost 2) gets at most a half cell closer on both axes, and every move across a cell
+// (cost 3) a cell closer on one
+static uint32_t GoalDistance(int x, int y, const std::vector<Point>& goals) {
+	uint32_t best = UINT32_MAX;
+	for (const Point& goal : goals) {
+		int dx = std::max(0, std::abs(x - (2 * goal.x + 1)) - 1);
+		int dy = std::max(0, std::abs(y - (2 * goal.y + 1)) - 1);
+		best = std::min(best, (uint32_t)(3 * std::max(dx, dy) + std::min(dx, dy)) / 2);
+	}
+	return best;
+}
+
+// A* over the edges, from the edges of cell `from` at cost 0. Heap entries pack
+// (estimated cost << 32 | edge index), and the outdated ones are skipped.
+int DiagonalSolver::FindPath(Point from, const std::vector<Point>& goals, bool visited_edges_only, std::vector<PathNode>& dest) {
+	dest.clear();
+	stats.path_searches++;
+	if (from.x < 0 || from.y < 0 || from.x >= cols || from.y >= rows || goals.empty()) {
+		return -1;
+	}
 
-			// Vertical floodfill values
-			if ((ff_val_f = FF_VAL_TO_FLOAT(edges[false][i][j].ff_val)) >= 0.0f) {
-				snprintf(
-					buffer,
-					sizeof(buffer),
-					"%.1f\n%s,%d",
-					ff_val_f,
-					DirToStr(edges[false][i][j].dir).c_str(),
-					edges[false][i][j].same_dir
-				);
+	size_t edge_count = 2 * (size_t)(rows + 1) * (cols + 1);
+	search_costs.assign(edge_count, UINT32_MAX);
+	search_parents.resize(edge_count);
+	search_heap.clear();
+
+	bool horizontals[4];
+	Point edge_coords[4];
+	GetEdgesOfCell(horizontals, edge_coords, from);
+	for (int i = 0; i < 4; i++) {
+		if (edges[horizontals[i]][edge_coords[i].y][edge_coords[i].x].wall_exists) {
+			continue;
+		}
+		int x = horizontals[i] ? 2 * edge_coords[i].x + 1 : 2 * edge_coords[i].x;
+		int y = horizontals[i] ? 2 * edge_coords[i].y : 2 * edge_coords[i].y + 1;
+		int index = (!(y & 1) * (rows + 1) + (y >> 1)) * (cols + 1) + (x >> 1);
+		search_costs[index] = 0;
+		search_parents[index] = -1;
+		search_heap.push_back((uint64_t)GoalDistance(x, y, goals) << 32 | (uint32_t)index);
+		std::push_heap(search_heap.begin(), search_heap.end(), std::greater<uint64_t>());
+	}
 
-				x = p.x - GuiGetTextWidth(buffer) / 2.0f;
-				y = p.y + (MAZE_CELL_SIZE - TEXT_HEIGHT) / 2.0f;
+	long long expanded = 0;
+	int found = -1;
+	while (!search_heap.empty()) {
+		std::pop_heap(search_heap.begin(), search_heap.end(), std::greater<uint64_t>());
+		uint64_t entry = search_heap.back();
+		search_heap.pop_back();
+
+		int index = (int)(uint32_t)entry;
+		int edge_row = index / (cols + 1);
+		bool horizontal = edge_row > rows;
+		int x = 2 * (index % (cols + 1)) + horizontal;
+		int y = 2 * (edge_row - (horizontal ? rows + 1 : 0)) + !horizontal;
+		uint32_t cost = search_costs[index];
+		uint32_t distance = GoalDistance(x, y, goals);
+		if ((uint32_t)(entry >> 32) > cost + distance) {
+			continue;
+		}
+		expanded++;
 
-				GuiSetStyle(DEFAULT, TEXT_COLOR_NORMAL, ColorToInt(BLUE));
+		bool at_goal = false;
+		for (const Point& goal : goals) {
+			at_goal |= std::abs(x - (2 * goal.x + 1)) + std::abs(y - (2 * goal.y + 1)) == 1;
+		}
+		if (at_goal) {
+			found = index;
+			break;
+		}
 
-				GuiSetStyle(DEFAULT, TEXT_SIZE, TEXT_HEIGHT);
-				GuiLabel(ray::Rectangle(x, y, 50.0f, TEXT_HEIGHT), buffer);
+		// Into the cells on either side, to their other edges
+		for (int heading = 0; heading < HEADING_COUNT; heading++) {
+			int next_x = x;
+			int next_y = y;
+			if (!PlanMove(&next_x, &next_y, heading, visited_edges_only)) {
+				continue;
+			}
+			uint32_t next_cost = cost + (heading & 1 ? 2 : 3);
+			int next_index = (!(next_y & 1) * (rows + 1) + (next_y >> 1)) * (cols + 1) + (next_x >> 1);
+			if (next_cost < search_costs[next_index]) {
+				search_costs[next_index] = next_cost;
+				search_parents[next_index] = index;
+				search_heap.push_back((uint64_t)(next_cost + GoalDistance(next_x, next_y, goals)) << 32 | (uint32_t)next_index);
+				std::push_heap(search_heap.begin(), search_heap.end(), std::greater<uint64_t>());
 			}
 		}
 	}
+	stats.search_expansions += expanded;
+
+	if (found < 0) {
+		return -1;
+	}
+
+	// From the goal back, so the first edge ends up last
+	for (int index = found; index >= 0; index = search_parents[index]) {
+		int edge_row = index / (cols + 1);
+		bool horizontal = edge_row > rows;
+		dest.push_back(PathNode(horizontal, Point((int16_t)(index % (cols + 1)), (int16_t)(edge_row - (horizontal ? rows + 1 : 0)))));
+	}
+	return (int)search_costs[found];
+}
 
-	GuiSetFont(GetFontDefault());
-	GuiSetStyle(DEFAULT, TEXT_SIZE, default_text_size);
-	GuiSetStyle(DEFAULT, TEXT_COLOR_NORMAL, default_text_clr);
+void EdgePathWaypoints(const std::vector<PathNode>& path, Point start, std::vector<Waypoint>& dest) {
+	dest.clear();
+	dest.push_back({ 2 * start.x + 1, 2 * start.y + 1 });
+	for (int i = (int)path.size() - 1; i >= 0; i--) {
+		const PathNode& node = path[i];
+		dest.push_back({
+			node.horizontal ? 2 * node.edge_coord.x + 1 : 2 * node.edge_coord.x,
+			node.horizontal ? 2 * node.edge_coord.y : 2 * node.edge_coord.y + 1
+		});
+	}
+}
+
+void DiagonalSolver::PathWaypoints(std::vector<Waypoint>& dest) {
+	EdgePathWaypoints(path, coord, dest);
+}
+
+void DiagonalSolver::SolutionWaypoints(std::vector<Waypoint>& dest) {
+	EdgePathWaypoints(solution_path, starting_coord, dest);
+}
+
+void DiagonalSolver::FastRunWaypoints(std::vector<Waypoint>& dest) {
+	EdgePathWaypoints(fast_path, starting_coord, dest);
+}
+
+bool DiagonalSolver::IsFinished() {
+	return finished;
+}
+
+bool DiagonalSolver::VerifyFloodfill() {
+	bool matches = VerifyCurrentFlood();
+	if (goal_flood_ready) {
+		SwapFlood(goal_flood);
+		matches = VerifyCurrentFlood() && matches;
+		SwapFlood(goal_flood);
+	}
+	return matches;
+}
+
+// Checks the floodfill currently in the flood members, see VerifyFloodfill()
+bool DiagonalSolver::VerifyCurrentFlood() {
+	if (!flood_valid) {
+		return true;
+	}
+
+	Grid<Edge> current_edges[2] = { edges[0], edges[1] };
+	Point current_coord = coord;
+	SolverStats current_stats = stats;
+
+	// Flood again from the same place, with the edges as they were during the last floodfill
+	for (PathNode& node : changed_edges) {
+		Edge& edge = edges[node.horizontal][node.edge_coord.y][node.edge_coord.x];
+		edge.visited = false;
+		edge.wall_exists = false;
+	}
+	coord = flood_coord;
+	StartFlood<0, 0>(flood_visited_edges_only);
+	ContinueFlood<0, 0>();
+
+	bool matches = true;
+	MazeDims<0, 0> dims = { rows, cols };
+	FOREACH_EDGE(dims,
+		Edge& current_edge = current_edges[horizontal][0][index];
+		matches = matches
+			&& edge.ff_val == current_edge.ff_val
+			&& edge.dir == current_edge.dir
+			&& edge.same_dir == current_edge.same_dir;
+	);
+
+	for (int horizontal = 0; horizontal < 2; horizontal++) {
+		edges[horizontal] = current_edges[horizontal];
+	}
+	coord = current_coord;
+	stats = current_stats;
+	return matches;
 }
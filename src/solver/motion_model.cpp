@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+#include "solver/motion_model.hpp"
+
+static const char* primitive_names[PRIMITIVE_TYPE_COUNT] = {
+	"straight", "diagonal", "s45in", "s45out", "s90", "v90", "s135in", "s135out", "s180"
+};
+
+// Turn and diagonal moves across cells of each primitive type
+static const int primitive_turns[PRIMITIVE_TYPE_COUNT] = {
+	-1, -1, TURN_45, TURN_45, TURN_90, TURN_90, TURN_135, TURN_135, TURN_180
+};
+static const int primitive_turn_moves[PRIMITIVE_TYPE_COUNT] = {
+	0, 0, 0, 0, 1, 0, 1, 1, 2
+};
+
+const char* MotionPrimitiveName(MotionPrimitiveType type) {
+	return type < PRIMITIVE_TYPE_COUNT ? primitive_names[type] : "unknown";
+}
+
+MotionProfile DefaultMotionProfile() {
+	MotionProfile profile;
+	profile.cell_size = 0.18f;
+	profile.max_speed = 3.0f;
+	profile.max_diagonal_speed = 2.0f;
+	profile.acceleration = 8.0f;
+	profile.deceleration = 8.0f;
+	profile.turns[TURN_45] = { 1.2f, 0.04f };
+	profile.turns[TURN_90] = { 0.9f, 0.08f };
+	profile.turns[TURN_135] = { 0.7f, 0.14f };
+	profile.turns[TURN_180] = { 0.5f, 0.22f };
+	return profile;
+}
+
+int ParseMotionProfile(const std::string& text, MotionProfile* profile) {
+	struct Field {
+		const char* name;
+		float* value;
+		bool positive; // Must be above 0, not only at least 0
+	};
+	Field fields[] = {
+		{ "cell_size", &profile->cell_size, true },
+		{ "max_speed", &profile->max_speed, true },
+		{ "max_diagonal_speed", &profile->max_diagonal_speed, true },
+		{ "acceleration", &profile->acceleration, true },
+		{ "deceleration", &profile->deceleration, true },
+		{ "turn45_speed", &profile->turns[TURN_45].speed, true },
+		{ "turn45_time", &profile->turns[TURN_45].time, false },
+		{ "turn90_speed", &profile->turns[TURN_90].speed, true },
+		{ "turn90_time", &profile->turns[TURN_90].time, false },
+		{ "turn135_speed", &profile->turns[TURN_135].speed, true },
+		{ "turn135_time", &profile->turns[TURN_135].time, false },
+		{ "turn180_speed", &profile->turns[TURN_180].speed, true },
+		{ "turn180_time", &profile->turns[TURN_180].time, false }
+	};
+
+	size_t begin = 0;
+	while (begin < text.size()) {
+		size_t end = text.find(',', begin);
+		if (end == std::string::npos) {
+			end = text.size();
+		}
+		std::string item = text.substr(begin, end - begin);
+		begin = end + 1;
+
+		size_t equals = item.find('=');
+		if (equals == std::string::npos) {
+			return 0;
+		}
+		std::string name = item.substr(0, equals);
+		std::string value_text = item.substr(equals + 1);
+		char* value_end = nullptr;
+		float value = strtof(value_text.c_str(), &value_end);
+		if (value_text.empty() || *value_end != '\0' || !std::isfinite(value)) {
+			return 0;
+		}
+
+		bool found = false;
+		for (Field& field : fields) {
+			if (name == field.name) {
+				if (value < 0.0f || (field.positive && value == 0.0f)) {
+					return 0;
+				}
+				*field.value = value;
+				found = true;
+			}
+		}
+		if (!found) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+MotionModel::MotionModel() {
+	SetProfile(DefaultMotionProfile());
+}
+
+MotionModel::MotionModel(const MotionProfile& profile) {
+	SetProfile(profile);
+}
+
+void MotionModel::SetProfile(const MotionProfile& profile) {
+	this->profile = profile;
+	BuildTables();
+}
+
+float MotionModel::TrapezoidTime(float distance, float v0, float v1, float v_max, float acceleration, float deceleration) {
+	if (distance <= 0.0f) {
+		return 0.0f;
+	}
+
+	// Clamp the end speeds to what can actually be reached over the distance
+	v0 = std::min(v0, v_max);
+	v1 = std::min(v1, v_max);
+	v0 = std::min(v0, sqrtf(v1 * v1 + 2.0f * deceleration * distance));
+	v1 = std::min(v1, sqrtf(v0 * v0 + 2.0f * acceleration * distance));
+
+	// Accelerate then decelerate, meeting at the peak speed, unless that is over the top speed
+	float peak_squared = (2.0f * acceleration * deceleration * distance + deceleration * v0 * v0 + acceleration * v1 * v1)
+		/ (acceleration + deceleration);
+	if (peak_squared <= v_max * v_max) {
+		float peak = sqrtf(peak_squared);
+		return (peak - v0) / acceleration + (peak - v1) / deceleration;
+	}
+
+	float accelerating = (v_max * v_max - v0 * v0) / (2.0f * acceleration);
+	float decelerating = (v_max * v_max - v1 * v1) / (2.0f * deceleration);
+	return (v_max - v0) / acceleration + (v_max - v1) / deceleration
+		+ (distance - accelerating - decelerating) / v_max;
+}
+
+void MotionModel::BuildTables() {
+	unit_length[0] = profile.cell_size / 2.0f;
+	unit_length[1] = profile.cell_size * SQRT_2 / 2.0f;
+	top_speed[0] = profile.max_speed;
+	top_speed[1] = profile.max_diagonal_speed;
+	for (int i = 0; i < MOTION_TURN_COUNT; i++) {
+		end_speeds[i] = profile.turns[i].speed;
+	}
+	end_speeds[MOTION_SPEED_STOP] = 0.0f;
+
+	// Turns cross their cells at the turn speed
+	for (int i = 0; i < PRIMITIVE_TYPE_COUNT; i++) {
+		int turn = primitive_turns[i];
+		turn_primitive_times[i] = turn < 0 ? 0.0f
+			: primitive_turn_moves[i] * unit_length[1] / std::min(profile.turns[turn].speed, top_speed[1]) + profile.turns[turn].time;
+	}
+
+	for (int diagonal = 0; diagonal < 2; diagonal++) {
+		// Long enough to reach top speed and stop again, after which the time only grows linearly
+		float v = top_speed[diagonal];
+		float full_stop_distance = v * v / (2.0f * profile.acceleration) + v * v / (2.0f * profile.deceleration);
+		table_length[diagonal] = (int)ceilf(full_stop_distance / unit_length[diagonal]) + 2;
+
+		straight_times[diagonal].resize((size_t)table_length[diagonal] * MOTION_SPEED_COUNT * MOTION_SPEED_COUNT);
+		for (int units = 0; units < table_length[diagonal]; units++) {
+			for (int entry = 0; entry < MOTION_SPEED_COUNT; entry++) {
+				for (int exit = 0; exit < MOTION_SPEED_COUNT; exit++) {
+					straight_times[diagonal][(units * MOTION_SPEED_COUNT + entry) * MOTION_SPEED_COUNT + exit] = TrapezoidTime(
+						units * unit_length[diagonal],
+						end_speeds[entry],
+						end_speeds[exit],
+						top_speed[diagonal],
+						profile.acceleration,
+						profile.deceleration
+					);
+				}
+			}
+		}
+	}
+}
+
+int MotionModel::PrimitiveTurn(MotionPrimitiveType type) {
+	return primitive_turns[type];
+}
+
+float MotionModel::RunTime(const std::vector<MotionPrimitive>& run) const {
+	float time = 0.0f;
+	int entry_speed = MOTION_SPEED_STOP;
+	for (size_t i = 0; i < run.size(); i++) {
+		const MotionPrimitive& primitive = run[i];
+		int turn = primitive_turns[primitive.type];
+		if (turn < 0) {
+			int exit_speed = i + 1 < run.size() && primitive_turns[run[i + 1].type] >= 0
+				? primitive_turns[run[i + 1].type]
+				: MOTION_SPEED_STOP;
+			time += StraightTime(primitive.type == PRIMITIVE_DIAGONAL, primitive.length, entry_speed, exit_speed);
+			continue;
+		}
+
+		time += turn_primitive_times[primitive.type];
+		entry_speed = turn;
+	}
+	return time;
+}
@@ -0,0 +1,131 @@
+#include <cstdlib>
+#include <vector>
+
+#include "solver/run_compiler.hpp"
+
+static int Sign(int x) {
+	return (x > 0) - (x < 0);
+}
+
+// Heading of a move by (dx, dy) half cells, clockwise from up
+static int HeadingOf(int dx, int dy) {
+	static const int headings[3][3] = {
+		{ 7, 6, 5 }, // dx < 0, by dy < 0, == 0, > 0
+		{ 0, -1, 4 },
+		{ 1, 2, 3 }
+	};
+	return headings[Sign(dx) + 1][Sign(dy) + 1];
+}
+
+int RunCompiler::Compile(const std::vector<Waypoint>& waypoints, std::vector<MotionPrimitive>& dest) {
+	stretches.clear();
+	dest.clear();
+
+	for (size_t i = 1; i < waypoints.size(); i++) {
+		const Waypoint& from = waypoints[i - 1];
+		int dx = waypoints[i].x - from.x;
+		int dy = waypoints[i].y - from.y;
+		bool diagonal = std::abs(dx) == 1 && std::abs(dy) == 1;
+
+		// Out of the starting cell, across a cell between opposite sides, or between neighboring sides
+		bool valid = i == 1
+			? (from.x & 1) && (from.y & 1) && std::abs(dx) + std::abs(dy) == 1
+			: (diagonal && ((from.x + from.y) & 1))
+				|| (dx == 0 && std::abs(dy) == 2 && (from.x & 1) && !(from.y & 1))
+				|| (dy == 0 && std::abs(dx) == 2 && !(from.x & 1) && (from.y & 1));
+		if (!valid) {
+			return 0;
+		}
+
+		int heading = HeadingOf(dx, dy);
+		int units = diagonal ? 1 : std::abs(dx) + std::abs(dy);
+		if (!stretches.empty() && stretches.back().heading == heading) {
+			stretches.back().moves++;
+			stretches.back().units += units;
+		} else {
+			stretches.push_back({ heading, 1, units });
+		}
+	}
+
+	if (stretches.empty()) {
+		return 1;
+	}
+
+	AddStraight(stretches[0], dest);
+	for (int i = 0; i + 1 < (int)stretches.size(); ) {
+		int matched = MatchTurn(i, dest);
+		if (matched == 0) {
+			return 0;
+		}
+		i += matched;
+		AddStraight(stretches[i], dest);
+	}
+	return 1;
+}
+
+void RunCompiler::AddStraight(const Stretch& stretch, std::vector<MotionPrimitive>& dest) {
+	dest.push_back({ stretch.heading & 1 ? PRIMITIVE_DIAGONAL : PRIMITIVE_STRAIGHT, false, stretch.units });
+}
+
+// Add the turn after stretch, taking in the single diagonal moves of S90, S135 and S180 turns.
+// Returns the number of stretches passed, or 0 if the turn is impossible.
+int RunCompiler::MatchTurn(int stretch, std::vector<MotionPrimitive>& dest) {
+	int count = (int)stretches.size() - stretch;
+	int turns[3] = { 0, 0, 0 }; // After each of the next stretches, in 45 degree steps clockwise
+	bool along_walls[4];
+	bool single[4]; // A single diagonal move
+	for (int i = 0; i < 4 && i < count; i++) {
+		const Stretch& s = stretches[stretch + i];
+		along_walls[i] = !(s.heading & 1);
+		single[i] = !along_walls[i] && s.moves == 1;
+		if (i > 0) {
+			int turn = (s.heading - stretches[stretch + i - 1].heading + 8) % 8;
+			turns[i - 1] = turn > 4 ? turn - 8 : turn;
+		}
+	}
+
+	int side = Sign(turns[0]);
+	bool right = side > 0;
+	if (count >= 4 && along_walls[0] && single[1] && single[2] && along_walls[3]
+		&& turns[0] == side && turns[1] == 2 * side && turns[2] == side) {
+		dest.push_back({ PRIMITIVE_S180, right, 0 });
+		return 3;
+	}
+	if (count >= 3 && single[1] && turns[0] * turns[1] > 0) {
+		if (along_walls[0] && along_walls[2] && turns[0] == side && turns[1] == side) {
+			dest.push_back({ PRIMITIVE_S90, right, 0 });
+			return 2;
+		}
+		if (along_walls[0] && !along_walls[2] && turns[0] == side && turns[1] == 2 * side) {
+			dest.push_back({ PRIMITIVE_S135_IN, right, 0 });
+			return 2;
+		}
+		if (!along_walls[0] && along_walls[2] && turns[0] == 2 * side && turns[1] == side) {
+			dest.push_back({ PRIMITIVE_S135_OUT, right, 0 });
+			return 2;
+		}
+	}
+
+	if (std::abs(turns[0]) == 1) {
+		dest.push_back({ along_walls[0] ? PRIMITIVE_S45_IN : PRIMITIVE_S45_OUT, right, 0 });
+		return 1;
+	}
+	if (std::abs(turns[0]) == 2 && !along_walls[0] && !along_walls[1]) {
+		dest.push_back({ PRIMITIVE_V90, right, 0 });
+		return 1;
+	}
+	return 0;
+}
+
+void CellPathWaypoints(const std::vector<Point>& path, Point start, std::vector<Waypoint>& dest) {
+	dest.clear();
+	dest.push_back({ 2 * start.x + 1, 2 * start.y + 1 });
+
+	// The side crossed between neighboring cells is halfway between their middles
+	Point from = start;
+	for (int i = (int)path.size() - 1; i >= 0; i--) {
+		const Point& to = path[i];
+		dest.push_back({ from.x + to.x + 1, from.y + to.y + 1 });
+		from = to;
+	}
+}
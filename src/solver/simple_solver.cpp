@@ -1,21 +1,35 @@
 #include <algorithm>
+#include <climits>
+#include <cstdlib>
 #include <cstring>
-#include <queue>
-#include <raylib.h>
-#include <raygui.h>
+#include <functional>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 #include "solver/simple_solver.hpp"
+#include "solver/maze_dims.hpp"
 #include "maze.hpp"
 
 // Returns true if a new wall (not seen before) is discovered around current cell
 bool SimpleSolver::FindSurroundingWalls() {
 	bool new_wall = false;
+	size_t first_change = changed_cells.size();
+	if (!cell_visited[coord.y][coord.x]) {
+		visited_hash ^= ZobristKey(ZOBRIST_VISITED, coord.y * cols + coord.x);
+	}
 	cell_visited[coord.y][coord.x] = true;
+	bool bitboards = UsesBitboards();
+	if (bitboards) visited_bits[coord.y] |= 1 << coord.x;
 
 	if (!h_wall_seen[coord.y][coord.x]) {
 		h_wall_seen[coord.y][coord.x] = true;
 		if (maze->WallAt(true, coord)) {
 			known_h_walls[coord.y][coord.x] = true;
+			walls_hash ^= ZobristKey(ZOBRIST_WALL, coord.y * cols + coord.x);
+			if (bitboards) h_open_bits[coord.y] &= ~(1 << coord.x);
+			changed_cells.push_back(Point(coord.x, coord.y - 1));
 			new_wall = true;
 		}
 	}
@@ -23,6 +37,9 @@ bool SimpleSolver::FindSurroundingWalls() {
 		h_wall_seen[coord.y + 1][coord.x] = true;
 		if (maze->WallAt(true, coord + Point(0, 1))) {
 			known_h_walls[coord.y + 1][coord.x] = true;
+			walls_hash ^= ZobristKey(ZOBRIST_WALL, (coord.y + 1) * cols + coord.x);
+			if (bitboards) h_open_bits[coord.y + 1] &= ~(1 << coord.x);
+			changed_cells.push_back(Point(coord.x, coord.y + 1));
 			new_wall = true;
 		}
 	}
@@ -30,6 +47,9 @@ bool SimpleSolver::FindSurroundingWalls() {
 		v_wall_seen[coord.y][coord.x] = true;
 		if (maze->WallAt(false, coord)) {
 			known_v_walls[coord.y][coord.x] = true;
+			walls_hash ^= ZobristKey(ZOBRIST_WALL, (rows + 1) * cols + coord.y * (cols + 1) + coord.x);
+			if (bitboards) v_open_bits[coord.y] &= ~(1 << coord.x);
+			changed_cells.push_back(Point(coord.x - 1, coord.y));
 			new_wall = true;
 		}
 	}
@@ -37,57 +57,421 @@ bool SimpleSolver::FindSurroundingWalls() {
 		v_wall_seen[coord.y][coord.x + 1] = true;
 		if (maze->WallAt(false, coord + Point(1, 0))) {
 			known_v_walls[coord.y][coord.x + 1] = true;
+			walls_hash ^= ZobristKey(ZOBRIST_WALL, (rows + 1) * cols + coord.y * (cols + 1) + coord.x + 1);
+			if (bitboards) v_open_bits[coord.y] &= ~(1 << (coord.x + 1));
+			changed_cells.push_back(Point(coord.x + 1, coord.y));
 			new_wall = true;
 		}
 	}
 
+	if (new_wall) {
+		changed_cells.push_back(coord);
+		known_walls_version++;
+
+		if (goal_flood.valid) {
+			goal_flood.changed_cells.insert(goal_flood.changed_cells.end(), changed_cells.begin() + first_change, changed_cells.end());
+		}
+	}
 	return new_wall;
 }
 
-// BFS from target_coords outward, assigning Manhattan distance to each reachable cell.
-// If visited_cells_only, only cells the robot has physically visited are expanded.
+// Get the cells that can be moved to from p, given the known walls
+template <int ROWS, int COLS>
+int SimpleSolver::OpenNeighbors(Point p, Point neighbors[4]) {
+	MazeDims<ROWS, COLS> dims = { rows, cols };
+	const bool* known_h = known_h_walls[0];
+	const bool* known_v = known_v_walls[0];
+
+	int n = 0;
+	if (p.y > 0 && !known_h[dims.HWall(p)])                            neighbors[n++] = Point(p.x, (int16_t)(p.y - 1));
+	if (p.y < dims.Rows() - 1 && !known_h[dims.HWall(p) + dims.Cols()]) neighbors[n++] = Point(p.x, (int16_t)(p.y + 1));
+	if (p.x > 0 && !known_v[dims.VWall(p)])                            neighbors[n++] = Point((int16_t)(p.x - 1), p.y);
+	if (p.x < dims.Cols() - 1 && !known_v[dims.VWall(p) + 1])          neighbors[n++] = Point((int16_t)(p.x + 1), p.y);
+	return n;
+}
+
+// Assign each reachable cell its distance to the closest target.
+// Previous values are repaired when only new walls were discovered since they were computed,
+// which gives the same values as a full flood.
 void SimpleSolver::Floodfill(bool visited_cells_only) {
-	for (int r = 0; r < MAZE_ROWS; r++)
-		for (int c = 0; c < MAZE_COLS; c++)
-			ff_vals[r][c] = SIMPLE_FF_UNSET;
+	Floodfill(visited_cells_only, FLOODFILL_OTHER);
+}
+
+void SimpleSolver::Floodfill(bool visited_cells_only, FloodfillCause cause) {
+	floodfill_count++;
+	floodfill_version++;
+	stats.floodfills[cause]++;
+
+	// The same known walls and targets always flood the same way
+	bool cached = cache_floodfills && (size_t)rows * cols <= FLOOD_CACHE_MAX_CELLS;
+	uint64_t key = cached ? FloodKey(visited_cells_only) : 0;
+	SimpleFloodResult* result = cached ? flood_cache.Find(key) : nullptr;
+	if (result) {
+		stats.flood_cache_hits++;
+		ff_vals = result->vals;
+		ff_valid = true;
+		ff_visited_cells_only = visited_cells_only;
+		ff_targets = target_coords;
+		changed_cells.clear();
+		path = result->path;
+		stats.AddPath(path.size());
+		return;
+	}
+	if (cached) {
+		stats.flood_cache_misses++;
+	}
+
+	if (incremental_floodfill
+		&& ff_valid
+		&& !visited_cells_only
+		&& !ff_visited_cells_only
+		&& target_coords == ff_targets) {
+		stats.incremental_floodfills++;
+		(this->*repair_floodfill)();
+	} else {
+		FullFloodfill(visited_cells_only);
+	}
+	changed_cells.clear();
+
+	UpdatePath();
+	if (cached) {
+		SimpleFloodResult& stored = flood_cache.Insert(key);
+		stored.vals = ff_vals;
+		stored.path = path;
+	}
+}
 
-	std::queue<Point> q;
+// Hash of everything a floodfill reads: the known walls, the visited cells when only they are flooded,
+// the targets, and the cell the path is traced from
+uint64_t SimpleSolver::FloodKey(bool visited_cells_only) {
+	uint64_t key = walls_hash ^ ZobristKey(ZOBRIST_COORD, coord.y * cols + coord.x);
+	if (visited_cells_only) {
+		key ^= visited_hash ^ ZobristKey(ZOBRIST_VISITED_ONLY, 0);
+	}
+	for (size_t i = 0; i < target_coords.size(); i++) {
+		const Point& t = target_coords[i];
+		key ^= ZobristKey(ZOBRIST_TARGET, (uint64_t)i << 32 | (uint32_t)(t.y * cols + t.x));
+	}
+	return key;
+}
+
+// Recompute every floodfill value with the selected backend
+void SimpleSolver::FullFloodfill(bool visited_cells_only) {
+	if (floodfill_backend == SIMPLE_FF_BITBOARD && UsesBitboards()) {
+		(this->*bitboard_floodfill)(visited_cells_only);
+	} else {
+		(this->*queue_floodfill)(visited_cells_only);
+	}
+}
+
+// BFS from target_coords outward, assigning Manhattan distance to each reachable cell.
+// If visited_cells_only, only cells the robot has physically visited are expanded.
+template <int ROWS, int COLS>
+void SimpleSolver::QueueFloodfill(bool visited_cells_only) {
+	MazeDims<ROWS, COLS> dims = { rows, cols };
+	const bool* known_h = known_h_walls[0];
+	const bool* known_v = known_v_walls[0];
+	const bool* visited = cell_visited[0];
+	uint32_t* vals = ff_vals[0];
+
+	ff_valid = true;
+	ff_visited_cells_only = visited_cells_only;
+	ff_targets = target_coords;
+
+	ff_vals.Fill(SIMPLE_FF_UNSET);
+
+	RingQueue<Point>& q = ff_queue;
+	q.Clear();
+	long long pushes = 0;
+	long long pops = 0;
 	for (Point t : target_coords) {
-		if (t.x < 0 || t.x >= MAZE_COLS || t.y < 0 || t.y >= MAZE_ROWS) continue;
-		if (visited_cells_only && !cell_visited[t.y][t.x]) continue;
-		if (ff_vals[t.y][t.x] != SIMPLE_FF_UNSET) continue;
-		ff_vals[t.y][t.x] = 0;
-		q.push(t);
+		if (t.x < 0 || t.x >= dims.Cols() || t.y < 0 || t.y >= dims.Rows()) continue;
+		if (visited_cells_only && !visited[dims.Cell(t)]) continue;
+		if (vals[dims.Cell(t)] != SIMPLE_FF_UNSET) continue;
+		vals[dims.Cell(t)] = 0;
+		q.Push(t);
+		pushes++;
 	}
 
-	while (!q.empty()) {
-		Point p = q.front(); q.pop();
-		uint16_t next_val = (uint16_t)(ff_vals[p.y][p.x] + 1);
+	while (!q.Empty()) {
+		Point p = q.Pop();
+		pops++;
+		uint32_t next_val = vals[dims.Cell(p)] + 1;
 
 		auto try_expand = [&](Point n, bool wall) {
 			if (wall) return;
-			if (ff_vals[n.y][n.x] != SIMPLE_FF_UNSET) return;
-			if (visited_cells_only && !cell_visited[n.y][n.x]) return;
-			ff_vals[n.y][n.x] = next_val;
-			q.push(n);
+			if (vals[dims.Cell(n)] != SIMPLE_FF_UNSET) return;
+			if (visited_cells_only && !visited[dims.Cell(n)]) return;
+			vals[dims.Cell(n)] = next_val;
+			q.Push(n);
+			pushes++;
 		};
 
-		if (p.y > 0)             try_expand(Point(p.x, (int8_t)(p.y - 1)), known_h_walls[p.y][p.x]);
-		if (p.y < MAZE_ROWS - 1) try_expand(Point(p.x, (int8_t)(p.y + 1)), known_h_walls[p.y + 1][p.x]);
-		if (p.x > 0)             try_expand(Point((int8_t)(p.x - 1), p.y), known_v_walls[p.y][p.x]);
-		if (p.x < MAZE_COLS - 1) try_expand(Point((int8_t)(p.x + 1), p.y), known_v_walls[p.y][p.x + 1]);
+		if (p.y > 0)               try_expand(Point(p.x, (int16_t)(p.y - 1)), known_h[dims.HWall(p)]);
+		if (p.y < dims.Rows() - 1) try_expand(Point(p.x, (int16_t)(p.y + 1)), known_h[dims.HWall(p) + dims.Cols()]);
+		if (p.x > 0)               try_expand(Point((int16_t)(p.x - 1), p.y), known_v[dims.VWall(p)]);
+		if (p.x < dims.Cols() - 1) try_expand(Point((int16_t)(p.x + 1), p.y), known_v[dims.VWall(p) + 1]);
 	}
 
-	UpdatePath();
+	stats.queue_pushes += pushes;
+	stats.queue_pops += pops;
+	stats.expansions += pops;
+}
+
+#ifdef __AVX2__
+// A 16-row bitboard is exactly one 256-bit register, with row r in 16-bit lane r
+
+// Lane r gets lane r + 1 of v, and the last lane becomes 0
+static inline __m256i NextRows(__m256i v) {
+	return _mm256_alignr_epi8(_mm256_permute2x128_si256(v, v, 0x81), v, 2);
+}
+
+// Lane r gets lane r - 1 of v, and the first lane becomes 0
+static inline __m256i PreviousRows(__m256i v) {
+	return _mm256_alignr_epi8(v, _mm256_permute2x128_si256(v, v, 0x08), 14);
+}
+
+// ExpandWavefront() over all of exactly 16 rows
+static bool ExpandWavefront16(uint16_t* frontier, uint16_t* reached,
+	const uint16_t* h_open, const uint16_t* v_open, const uint16_t* mask, int* first_row, int* last_row) {
+	__m256i f = _mm256_loadu_si256((const __m256i*)frontier);
+	__m256i h = _mm256_loadu_si256((const __m256i*)h_open);
+	__m256i v = _mm256_loadu_si256((const __m256i*)v_open);
+
+	__m256i next = NextRows(_mm256_and_si256(f, h));                        // Up
+	next = _mm256_or_si256(next, _mm256_and_si256(PreviousRows(f), h));     // Down
+	next = _mm256_or_si256(next, _mm256_srli_epi16(_mm256_and_si256(f, v), 1)); // Left
+	next = _mm256_or_si256(next, _mm256_and_si256(_mm256_slli_epi16(f, 1), v)); // Right
+
+	__m256i r = _mm256_loadu_si256((const __m256i*)reached);
+	next = _mm256_andnot_si256(r, next);
+	if (mask) {
+		next = _mm256_and_si256(next, _mm256_loadu_si256((const __m256i*)mask));
+	}
+
+	_mm256_storeu_si256((__m256i*)frontier, next);
+	_mm256_storeu_si256((__m256i*)reached, _mm256_or_si256(r, next));
+	*first_row = 0;
+	*last_row = 15;
+	return !_mm256_testz_si256(next, next);
+}
+#endif
+
+// Move the frontier one step in every open direction, keeping only cells not reached before.
+// Only rows first_row to last_row of the frontier may have bits set, and they are narrowed to the rows
+// of the new frontier, so a thin wavefront in a long corridor costs a few rows per step instead of all of them.
+// Returns false when no new cell was reached.
+template <int ROWS, int COLS>
+static bool ExpandWavefront(MazeDims<ROWS, COLS> dims, uint16_t* frontier, uint16_t* reached,
+	const uint16_t* h_open, const uint16_t* v_open, const uint16_t* mask, int* first_row, int* last_row) {
+#ifdef __AVX2__
+	if (dims.Rows() == 16) {
+		return ExpandWavefront16(frontier, reached, h_open, v_open, mask, first_row, last_row);
+	}
+#endif
+
+	int begin = std::max(0, *first_row - 1);
+	int end = std::min(dims.Rows() - 1, *last_row + 1);
+	int new_first = INT_MAX;
+	int new_last = -1;
+	uint16_t previous = begin > 0 ? frontier[begin - 1] : 0; // The row above, before it was replaced
+	for (int r = begin; r <= end; r++) {
+		uint16_t current = frontier[r];
+		uint16_t n = (uint16_t)(((current & v_open[r]) >> 1) | ((current << 1) & v_open[r]));
+		if (r + 1 < dims.Rows()) n |= frontier[r + 1] & h_open[r + 1];
+		n |= previous & h_open[r];
+		n &= ~reached[r];
+		if (mask) n &= mask[r];
+		frontier[r] = n;
+		reached[r] |= n;
+		previous = current;
+		if (n) {
+			new_first = std::min(new_first, r);
+			new_last = r;
+		}
+	}
+
+	*first_row = new_first;
+	*last_row = new_last;
+	return new_last >= 0;
+}
+
+static inline int LowestBit(uint16_t bits) {
+#ifdef __GNUC__
+	return __builtin_ctz(bits);
+#else
+	int c = 0;
+	while (!(bits & 1)) { bits >>= 1; c++; }
+	return c;
+#endif
+}
+
+// Number of set bits in count rows, four rows at a time
+static int CountBits(const uint16_t* bits, int count) {
+	int total = 0;
+	int r = 0;
+	for (; r <= count - 4; r += 4) {
+		uint64_t x;
+		memcpy(&x, bits + r, sizeof(x));
+		x = x - ((x >> 1) & 0x5555555555555555ull);
+		x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+		x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+		total += (int)((x * 0x0101010101010101ull) >> 56);
+	}
+	for (; r < count; r++) {
+		for (uint16_t b = bits[r]; b; b &= b - 1) total++;
+	}
+	return total;
+}
+
+// Same values as QueueFloodfill, but the whole frontier is expanded at once per distance,
+// with shifts and masks over the wall bitboards.
+template <int ROWS, int COLS>
+void SimpleSolver::BitboardFloodfill(bool visited_cells_only) {
+	MazeDims<ROWS, COLS> dims = { rows, cols };
+	uint32_t* vals = ff_vals[0];
+	ff_valid = true;
+	ff_visited_cells_only = visited_cells_only;
+	ff_targets = target_coords;
+
+	ff_vals.Fill(SIMPLE_FF_UNSET);
+
+	// The frontier and reached bitboards, one after another
+	uint16_t* frontier = wavefront_bits.data();
+	uint16_t* reached = frontier + dims.Rows();
+	std::fill(frontier, frontier + dims.Rows(), 0);
+	int first_row = INT_MAX;
+	int last_row = -1;
+	for (Point t : target_coords) {
+		if (t.x < 0 || t.x >= dims.Cols() || t.y < 0 || t.y >= dims.Rows()) continue;
+		if (visited_cells_only && !cell_visited[t.y][t.x]) continue;
+		frontier[t.y] |= 1 << t.x;
+		first_row = std::min(first_row, (int)t.y);
+		last_row = std::max(last_row, (int)t.y);
+	}
+	if (last_row < 0) {
+		return;
+	}
+
+	std::copy(frontier, frontier + dims.Rows(), reached);
+	const uint16_t* mask = visited_cells_only ? visited_bits.data() : nullptr;
+
+	uint32_t val = 0;
+	do {
+		for (int r = first_row; r <= last_row; r++) {
+			for (uint16_t bits = frontier[r]; bits; bits &= bits - 1) {
+				vals[r * dims.Cols() + LowestBit(bits)] = val;
+			}
+		}
+		val++;
+	} while (ExpandWavefront(dims, frontier, reached, h_open_bits.data(), v_open_bits.data(), mask, &first_row, &last_row));
+
+	stats.expansions += CountBits(reached, dims.Rows());
+}
+
+// Walls can only make distances longer. A cell keeps its value as long as a neighbor
+// one step closer to a target still leads to it; the cells that lost every such neighbor
+// are cleared and reflooded from the cells around them.
+template <int ROWS, int COLS>
+void SimpleSolver::RepairFloodfill() {
+	MazeDims<ROWS, COLS> dims = { rows, cols };
+	uint32_t* vals = ff_vals[0];
+	Point neighbors[4];
+
+	// Clear the values of cells that are no longer supported by a closer neighbor
+	raised_cells.clear();
+	for (size_t i = 0; i < changed_cells.size(); i++) {
+		Point p = changed_cells[i];
+		if (p.x < 0 || p.x >= dims.Cols() || p.y < 0 || p.y >= dims.Rows()) continue;
+
+		uint32_t val = vals[dims.Cell(p)];
+		if (val == 0 || val == SIMPLE_FF_UNSET) continue;
+
+		bool supported = false;
+		int n = OpenNeighbors<ROWS, COLS>(p, neighbors);
+		for (int j = 0; j < n && !supported; j++) {
+			supported = vals[dims.Cell(neighbors[j])] == val - 1;
+		}
+		if (supported) continue;
+
+		vals[dims.Cell(p)] = SIMPLE_FF_UNSET;
+		raised_cells.push_back(p);
+
+		// Cells that were one step further away may have depended on this one
+		for (int j = 0; j < n; j++) {
+			if (vals[dims.Cell(neighbors[j])] == val + 1) {
+				changed_cells.push_back(neighbors[j]);
+			}
+		}
+	}
+
+	// Heap entries pack (value << 32 | cell index), so the smallest value pops first
+	repair_heap.clear();
+	long long pushes = 0;
+	long long pops = 0;
+	long long expanded = 0;
+	for (Point p : raised_cells) {
+		uint64_t best = SIMPLE_FF_UNSET;
+		int n = OpenNeighbors<ROWS, COLS>(p, neighbors);
+		for (int j = 0; j < n; j++) {
+			best = std::min(best, (uint64_t)vals[dims.Cell(neighbors[j])] + 1);
+		}
+		if (best < SIMPLE_FF_UNSET) {
+			pushes++;
+			repair_heap.push_back(best << 32 | (uint32_t)dims.Cell(p));
+			std::push_heap(repair_heap.begin(), repair_heap.end(), std::greater<uint64_t>());
+		}
+	}
+
+	// Reflood the cleared cells in order of distance
+	while (!repair_heap.empty()) {
+		std::pop_heap(repair_heap.begin(), repair_heap.end(), std::greater<uint64_t>());
+		uint64_t entry = repair_heap.back();
+		repair_heap.pop_back();
+		pops++;
+
+		uint32_t val = (uint32_t)(entry >> 32);
+		uint32_t index = (uint32_t)entry;
+		Point p = Point((int16_t)(index % dims.Cols()), (int16_t)(index / dims.Cols()));
+		if (val >= vals[index]) continue;
+		vals[index] = val;
+		expanded++;
+
+		int n = OpenNeighbors<ROWS, COLS>(p, neighbors);
+		for (int j = 0; j < n; j++) {
+			Point q = neighbors[j];
+			if (val + 1 < vals[dims.Cell(q)]) {
+				pushes++;
+				repair_heap.push_back((uint64_t)(val + 1) << 32 | (uint32_t)dims.Cell(q));
+				std::push_heap(repair_heap.begin(), repair_heap.end(), std::greater<uint64_t>());
+			}
+		}
+	}
+
+	stats.queue_pushes += pushes;
+	stats.queue_pops += pops;
+	stats.expansions += expanded;
+}
+
+// Trace the path along the current floodfill values
+void SimpleSolver::UpdatePath() {
+	(this->*trace_path)();
+	stats.AddPath(path.size());
 }
 
 // Greedily traces the shortest path from coord toward any target by following
 // decreasing floodfill values. Stores path in reverse so path.back() = next step.
-void SimpleSolver::UpdatePath() {
+template <int ROWS, int COLS>
+void SimpleSolver::TracePath() {
+	MazeDims<ROWS, COLS> dims = { rows, cols };
+	const bool* known_h = known_h_walls[0];
+	const bool* known_v = known_v_walls[0];
+	const uint32_t* vals = ff_vals[0];
+
 	path.clear();
 
 	Point cur = coord;
-	int max_steps = MAZE_ROWS * MAZE_COLS;
+	int max_steps = dims.Rows() * dims.Cols();
 
 	while (max_steps-- > 0) {
 		for (Point& t : target_coords) {
@@ -97,20 +481,20 @@ void SimpleSolver::UpdatePath() {
 			}
 		}
 
-		if (ff_vals[cur.y][cur.x] == SIMPLE_FF_UNSET) break;
+		if (vals[dims.Cell(cur)] == SIMPLE_FF_UNSET) break;
 
 		Point best = cur;
-		uint16_t best_val = ff_vals[cur.y][cur.x];
+		uint32_t best_val = vals[dims.Cell(cur)];
 
 		auto try_neighbor = [&](Point n, bool wall) {
 			if (wall) return;
-			if (ff_vals[n.y][n.x] < best_val) { best = n; best_val = ff_vals[n.y][n.x]; }
+			if (vals[dims.Cell(n)] < best_val) { best = n; best_val = vals[dims.Cell(n)]; }
 		};
 
-		if (cur.y > 0)             try_neighbor(Point(cur.x, (int8_t)(cur.y - 1)), known_h_walls[cur.y][cur.x]);
-		if (cur.y < MAZE_ROWS - 1) try_neighbor(Point(cur.x, (int8_t)(cur.y + 1)), known_h_walls[cur.y + 1][cur.x]);
-		if (cur.x > 0)             try_neighbor(Point((int8_t)(cur.x - 1), cur.y), known_v_walls[cur.y][cur.x]);
-		if (cur.x < MAZE_COLS - 1) try_neighbor(Point((int8_t)(cur.x + 1), cur.y), known_v_walls[cur.y][cur.x + 1]);
+		if (cur.y > 0)               try_neighbor(Point(cur.x, (int16_t)(cur.y - 1)), known_h[dims.HWall(cur)]);
+		if (cur.y < dims.Rows() - 1) try_neighbor(Point(cur.x, (int16_t)(cur.y + 1)), known_h[dims.HWall(cur) + dims.Cols()]);
+		if (cur.x > 0)               try_neighbor(Point((int16_t)(cur.x - 1), cur.y), known_v[dims.VWall(cur)]);
+		if (cur.x < dims.Cols() - 1) try_neighbor(Point((int16_t)(cur.x + 1), cur.y), known_v[dims.VWall(cur) + 1]);
 
 		if (best == cur) break;
 
@@ -124,26 +508,124 @@ void SimpleSolver::UpdatePath() {
 // Compute the unvisited cells on the currently optimal path (start -> goal) to visit
 // before heading home, so the robot can potentially discover a shorter route.
 void SimpleSolver::UpdateTargetCoords() {
-	Point tmp_coord = coord;
+	stats.target_updates++;
 
-	coord = starting_coord;
-	target_coords = maze->goals;
-	Floodfill(false);
+	if (astar_target_paths) {
+		FindPath(starting_coord, maze->goals, false, goal_flood.path);
+	} else {
+		UpdateGoalFlood();
+	}
 
 	std::vector<Point> unvisited;
-	for (Point& p : path) {
+	for (Point& p : goal_flood.path) {
 		if (!cell_visited[p.y][p.x]) {
 			unvisited.push_back(p);
 		}
 	}
 
-	coord = tmp_coord;
 	target_coords = unvisited;
 	if (target_coords.empty()) {
 		target_coords = { starting_coord };
 	}
 }
 
+// Bring the floodfill from the goals up to date with the walls found since it last ran, and trace the path
+// from the starting cell into goal_flood.path. The navigation floodfill is swapped out meanwhile, so it is
+// left as it was and can still be repaired.
+void SimpleSolver::UpdateGoalFlood() {
+	SwapFlood(goal_flood);
+	Point tmp_coord = coord;
+	coord = starting_coord;
+	target_coords = maze->goals;
+	Floodfill(false, FLOODFILL_TARGET_CHANGE);
+	coord = tmp_coord;
+	SwapFlood(goal_flood);
+}
+
+// Exchange the current floodfill with the one in state
+void SimpleSolver::SwapFlood(SimpleFloodState& state) {
+	std::swap(ff_vals, state.vals);
+	std::swap(ff_valid, state.valid);
+	std::swap(ff_visited_cells_only, state.visited_cells_only);
+	std::swap(ff_targets, state.targets);
+	std::swap(changed_cells, state.changed_cells);
+	std::swap(path, state.path);
+}
+
+// Manhattan distance from p to the closest of goals, which no path can beat
+static uint32_t GoalDistance(Point p, const std::vector<Point>& goals) {
+	uint32_t best = SIMPLE_FF_UNSET;
+	for (const Point& goal : goals) {
+		best = std::min(best, (uint32_t)(std::abs(p.x - goal.x) + std::abs(p.y - goal.y)));
+	}
+	return best;
+}
+
+// Heap entries pack (estimated length << 32 | cell index), like the repair heap. A cell can be pushed
+// again when a shorter way to it is found, and the outdated entries are skipped.
+int SimpleSolver::FindPath(Point from, const std::vector<Point>& goals, bool visited_cells_only, std::vector<Point>& dest) {
+	dest.clear();
+	stats.path_searches++;
+	if (from.x < 0 || from.y < 0 || from.x >= cols || from.y >= rows || goals.empty()) {
+		return -1;
+	}
+
+	size_t cells = (size_t)rows * cols;
+	search_costs.assign(cells, SIMPLE_FF_UNSET);
+	search_parents.resize(cells);
+	search_heap.clear();
+
+	int from_index = from.y * cols + from.x;
+	search_costs[from_index] = 0;
+	search_heap.push_back((uint64_t)GoalDistance(from, goals) << 32 | (uint32_t)from_index);
+
+	long long expanded = 0;
+	int found = -1;
+	while (!search_heap.empty()) {
+		std::pop_heap(search_heap.begin(), search_heap.end(), std::greater<uint64_t>());
+		uint64_t entry = search_heap.back();
+		search_heap.pop_back();
+
+		int index = (int)(uint32_t)entry;
+		Point p = Point((int16_t)(index % cols), (int16_t)(index / cols));
+		uint32_t cost = search_costs[index];
+		uint32_t distance = GoalDistance(p, goals);
+		if ((uint32_t)(entry >> 32) > cost + distance) {
+			continue;
+		}
+		expanded++;
+		if (distance == 0) {
+			found = index;
+			break;
+		}
+
+		auto try_expand = [&](Point n, bool wall) {
+			int n_index = n.y * cols + n.x;
+			if (wall || (visited_cells_only && !cell_visited[n.y][n.x]) || cost + 1 >= search_costs[n_index]) return;
+			search_costs[n_index] = cost + 1;
+			search_parents[n_index] = index;
+			search_heap.push_back((uint64_t)(cost + 1 + GoalDistance(n, goals)) << 32 | (uint32_t)n_index);
+			std::push_heap(search_heap.begin(), search_heap.end(), std::greater<uint64_t>());
+		};
+
+		if (p.y > 0)        try_expand(Point(p.x, (int16_t)(p.y - 1)), known_h_walls[p.y][p.x]);
+		if (p.y < rows - 1) try_expand(Point(p.x, (int16_t)(p.y + 1)), known_h_walls[p.y + 1][p.x]);
+		if (p.x > 0)        try_expand(Point((int16_t)(p.x - 1), p.y), known_v_walls[p.y][p.x]);
+		if (p.x < cols - 1) try_expand(Point((int16_t)(p.x + 1), p.y), known_v_walls[p.y][p.x + 1]);
+	}
+	stats.search_expansions += expanded;
+
+	if (found < 0) {
+		return -1;
+	}
+
+	// From the goal back, so the first step ends up last
+	for (int index = found; index != from_index; index = search_parents[index]) {
+		dest.push_back(Point((int16_t)(index % cols), (int16_t)(index / cols)));
+	}
+	return (int)search_costs[found];
+}
+
 SimpleSolver::SimpleSolver(Maze* maze, Point starting_coord) {
 	this->maze = maze;
 	this->starting_coord = starting_coord;
@@ -152,42 +634,126 @@ SimpleSolver::SimpleSolver(Maze* maze, Point starting_coord) {
 
 SimpleSolver::~SimpleSolver() { }
 
+bool SimpleSolver::UsesBitboards() {
+	return cols <= SIMPLE_BITBOARD_MAX_COLS;
+}
+
+// Size the solver's storage for a rows x cols maze.
+// The floodfill and path buffers are allocated up front, so floodfills don't have to.
+void SimpleSolver::Resize(int rows, int cols) {
+	this->rows = rows;
+	this->cols = cols;
+
+	known_h_walls.Resize(rows + 1, cols);
+	known_v_walls.Resize(rows, cols + 1);
+	h_wall_seen.Resize(rows + 1, cols);
+	v_wall_seen.Resize(rows, cols + 1);
+	cell_visited.Resize(rows, cols);
+	ff_vals.Resize(rows, cols);
+	ff_queue.Resize((size_t)rows * cols);
+
+	int bitboard_rows = UsesBitboards() ? rows : 0;
+	h_open_bits.assign(bitboard_rows, 0);
+	v_open_bits.assign(bitboard_rows, 0);
+	visited_bits.assign(bitboard_rows, 0);
+	wavefront_bits.assign(2 * bitboard_rows, 0);
+
+	size_t cells = (size_t)rows * cols;
+	path.reserve(cells);
+	changed_cells.reserve(4 * cells);
+	raised_cells.reserve(cells);
+	repair_heap.reserve(4 * cells);
+	search_costs.reserve(cells);
+	search_parents.reserve(cells);
+	search_heap.reserve(4 * cells);
+	goal_flood.vals.Resize(rows, cols);
+	flood_cache.Clear();
+	goal_flood.changed_cells.reserve(4 * cells);
+	goal_flood.path.reserve(cells);
+}
+
+// Use the floodfill and path tracing code instantiated for ROWS x COLS
+template <int ROWS, int COLS>
+void SimpleSolver::UseSizedCode() {
+	queue_floodfill = &SimpleSolver::QueueFloodfill<ROWS, COLS>;
+	bitboard_floodfill = &SimpleSolver::BitboardFloodfill<ROWS, COLS>;
+	repair_floodfill = &SimpleSolver::RepairFloodfill<ROWS, COLS>;
+	trace_path = &SimpleSolver::TracePath<ROWS, COLS>;
+}
+
+// Standard competition sizes get code specialized for their size, others the generic code
+void SimpleSolver::SelectSizedCode() {
+	if (rows == 16 && cols == 16) {
+		UseSizedCode<16, 16>();
+	} else if (rows == 32 && cols == 32) {
+		UseSizedCode<32, 32>();
+	} else {
+		UseSizedCode<0, 0>();
+	}
+}
+
 void SimpleSolver::Reset() {
-	memset(known_h_walls, 0, sizeof(known_h_walls));
-	memset(known_v_walls, 0, sizeof(known_v_walls));
-	memset(h_wall_seen,   0, sizeof(h_wall_seen));
-	memset(v_wall_seen,   0, sizeof(v_wall_seen));
-	memset(cell_visited,  0, sizeof(cell_visited));
+	if (rows != maze->Rows() || cols != maze->Cols()) {
+		Resize(maze->Rows(), maze->Cols());
+		SelectSizedCode();
+	}
 
-	for (int c = 0; c < MAZE_COLS; c++) {
-		known_h_walls[0][c]         = true;
-		known_h_walls[MAZE_ROWS][c] = true;
-		h_wall_seen[0][c]           = true;
-		h_wall_seen[MAZE_ROWS][c]   = true;
+	known_h_walls.Fill(false);
+	known_v_walls.Fill(false);
+	h_wall_seen.Fill(false);
+	v_wall_seen.Fill(false);
+	cell_visited.Fill(false);
+
+	for (int c = 0; c < cols; c++) {
+		known_h_walls[0][c]    = true;
+		known_h_walls[rows][c] = true;
+		h_wall_seen[0][c]      = true;
+		h_wall_seen[rows][c]   = true;
+	}
+	for (int r = 0; r < rows; r++) {
+		known_v_walls[r][0]    = true;
+		known_v_walls[r][cols] = true;
+		v_wall_seen[r][0]      = true;
+		v_wall_seen[r][cols]   = true;
 	}
-	for (int r = 0; r < MAZE_ROWS; r++) {
-		known_v_walls[r][0]         = true;
-		known_v_walls[r][MAZE_COLS] = true;
-		v_wall_seen[r][0]           = true;
-		v_wall_seen[r][MAZE_COLS]   = true;
+
+	// Everything but the outer walls is open until walls are discovered
+	if (UsesBitboards()) {
+		uint16_t all_cols = (uint16_t)((1u << cols) - 1);
+		for (int r = 0; r < rows; r++) {
+			h_open_bits[r] = r > 0 ? all_cols : 0;
+			v_open_bits[r] = all_cols & ~1;
+			visited_bits[r] = 0;
+		}
 	}
 
 	run_number = 0;
+	floodfill_count = 0;
+	known_walls_version++;
+	ff_valid = false;
+	changed_cells.clear();
+	goal_flood.valid = false;
+	goal_flood.changed_cells.clear();
+	walls_hash = 0;
+	visited_hash = 0;
 	SoftReset();
 }
 
 void SimpleSolver::SoftReset() {
+	stats = SolverStats();
 	coord = starting_coord;
 	target_coords = maze->goals;
 	finished = false;
+	finished_paths_valid = false;
 	going_back = false;
 	run_number++;
 
 	FindSurroundingWalls();
-	Floodfill(run_number != 1);
+	Floodfill(run_number != 1, FLOODFILL_RUN_START);
 }
 
 void SimpleSolver::Step() {
+	StepTimer timer(stats);
 	if (path.empty()) return;
 
 	coord = path.back();
@@ -197,7 +763,7 @@ void SimpleSolver::Step() {
 		if (going_back) {
 			UpdateTargetCoords();
 		}
-		Floodfill(false);
+		Floodfill(false, FLOODFILL_NEW_WALLS);
 	}
 
 	auto it = std::find(target_coords.begin(), target_coords.end(), coord);
@@ -220,88 +786,69 @@ void SimpleSolver::Step() {
 			}
 		}
 
-		Floodfill(false);
+		Floodfill(false, FLOODFILL_TARGET_CHANGE);
 	}
 }
 
-bool SimpleSolver::IsFinished() {
-	return finished;
+bool SimpleSolver::UpdateFinishedPaths() {
+	if (!finished) {
+		return false;
+	}
+	if (finished_paths_valid && finished_paths_maze_version == maze->Version()) {
+		return true;
+	}
+
+	Floodfill(true);
+	solution_path = path;
+	Floodfill(false);
+	alternative_path = path;
+
+	finished_paths_valid = true;
+	finished_paths_maze_version = maze->Version();
+	return true;
 }
 
-void SimpleSolver::DrawPath(Color clr) {
-	ray::Vector2 from = maze->CellToPos(coord);
-	for (int i = (int)path.size() - 1; i >= 0; i--) {
-		ray::Vector2 to = maze->CellToPos(path[i]);
-		DrawLineEx(from, to, 3.0f, clr);
-		from = to;
-	}
+void SimpleSolver::PathWaypoints(std::vector<Waypoint>& dest) {
+	CellPathWaypoints(path, coord, dest);
 }
 
-void SimpleSolver::Draw(ray::Vector2 pos, bool show_floodfill_vals, Font floodfill_font) {
-	// Draw known horizontal walls
-	for (int r = 0; r <= MAZE_ROWS; r++) {
-		for (int c = 0; c < MAZE_COLS; c++) {
-			if (!known_h_walls[r][c]) continue;
-			ray::Vector2 from = pos + ray::Vector2(c * MAZE_CELL_SIZE, r * MAZE_CELL_SIZE);
-			DrawLineV(from, from + ray::Vector2(MAZE_CELL_SIZE, 0.0f), BLACK);
-		}
-	}
-	// Draw known vertical walls
-	for (int r = 0; r < MAZE_ROWS; r++) {
-		for (int c = 0; c <= MAZE_COLS; c++) {
-			if (!known_v_walls[r][c]) continue;
-			ray::Vector2 from = pos + ray::Vector2(c * MAZE_CELL_SIZE, r * MAZE_CELL_SIZE);
-			DrawLineV(from, from + ray::Vector2(0.0f, MAZE_CELL_SIZE), BLACK);
-		}
-	}
+void SimpleSolver::SolutionWaypoints(std::vector<Waypoint>& dest) {
+	CellPathWaypoints(solution_path, starting_coord, dest);
+}
 
-	DrawCircleV(maze->CellToPos(coord), MAZE_CELL_SIZE * 0.4f, ORANGE);
+bool SimpleSolver::IsFinished() {
+	return finished;
+}
 
-	for (int i = 0; i < MAZE_ROWS; i++) {
-		Vector2 p = maze->CornerToPos(Point(-1, i));
-		GuiLabel(ray::Rectangle(p.x + 10.0f, p.y, 50.0f, 50.0f), std::to_string(i).c_str());
-	}
-	for (int i = 0; i < MAZE_COLS; i++) {
-		Vector2 p = maze->CornerToPos(Point(i, MAZE_ROWS));
-		GuiLabel(ray::Rectangle(p.x + 10.0f, p.y, 50.0f, 50.0f), std::to_string(i).c_str());
-	}
+bool SimpleSolver::VerifyFloodfill() {
+	bool matches = VerifyCurrentFlood();
 
-	if (finished) {
-		Floodfill(true);
-		DrawPath(DARKBLUE);
-		Floodfill(false);
-		DrawPath(BLACK);
-	} else {
-		DrawPath(DARKBLUE);
+	// The start-to-goal floodfill is only current until walls are found
+	if (goal_flood.changed_cells.empty()) {
+		SwapFlood(goal_flood);
+		matches = VerifyCurrentFlood() && matches;
+		SwapFlood(goal_flood);
 	}
+	return matches;
+}
 
-	for (Point& t : target_coords) {
-		DrawCircleLinesV(maze->CellToPos(t), MAZE_CELL_SIZE * 0.4f, BLACK);
+// Checks the floodfill currently in the ff members, see VerifyFloodfill()
+bool SimpleSolver::VerifyCurrentFlood() {
+	if (!ff_valid) {
+		return true;
 	}
 
-	if (!show_floodfill_vals) return;
+	Grid<uint32_t> current_vals = ff_vals;
+	std::vector<Point> current_targets = target_coords;
+	SolverStats current_stats = stats;
 
-	const int TEXT_HEIGHT = 15;
-	int default_text_size = GuiGetStyle(DEFAULT, TEXT_SIZE);
-	int default_text_clr  = GuiGetStyle(DEFAULT, TEXT_COLOR_NORMAL);
-
-	GuiSetFont(floodfill_font);
-	GuiSetStyle(DEFAULT, TEXT_SIZE, TEXT_HEIGHT);
-	GuiSetStyle(DEFAULT, TEXT_COLOR_NORMAL, ColorToInt(DARKBLUE));
-
-	for (int r = 0; r < MAZE_ROWS; r++) {
-		for (int c = 0; c < MAZE_COLS; c++) {
-			if (ff_vals[r][c] == SIMPLE_FF_UNSET) continue;
-			char buffer[8];
-			snprintf(buffer, sizeof(buffer), "%u", ff_vals[r][c]);
-			ray::Vector2 cell_pos = maze->CellToPos(Point(c, r));
-			float x = cell_pos.x - GuiGetTextWidth(buffer) / 2.0f;
-			float y = cell_pos.y - TEXT_HEIGHT / 2.0f;
-			GuiLabel(ray::Rectangle(x, y, 50.0f, (float)TEXT_HEIGHT), buffer);
-		}
-	}
+	// Flood again from the same targets, with the generic queue BFS as the reference
+	target_coords = ff_targets;
+	QueueFloodfill<0, 0>(ff_visited_cells_only);
+	bool matches = current_vals == ff_vals;
 
-	GuiSetFont(GetFontDefault());
-	GuiSetStyle(DEFAULT, TEXT_SIZE, default_text_size);
-	GuiSetStyle(DEFAULT, TEXT_COLOR_NORMAL, default_text_clr);
+	ff_vals = current_vals;
+	target_coords = current_targets;
+	stats = current_stats;
+	return matches;
 }
@@ -0,0 +1,90 @@
+#include <string>
+
+#include "solver/solver_stats.hpp"
+
+static const char* cause_names[FLOODFILL_CAUSE_COUNT] = {
+	"other", "run_start", "new_walls", "target_change"
+};
+
+const char* FloodfillCauseName(FloodfillCause cause) {
+	return cause < FLOODFILL_CAUSE_COUNT ? cause_names[cause] : "unknown";
+}
+
+long long SolverStats::TotalFloodfills() const {
+	long long total = 0;
+	for (int i = 0; i < FLOODFILL_CAUSE_COUNT; i++) {
+		total += floodfills[i];
+	}
+	return total;
+}
+
+double SolverStats::FloodCacheHitRate() const {
+	long long lookups = flood_cache_hits + flood_cache_misses;
+	return lookups > 0 ? (double)flood_cache_hits / lookups : 0.0;
+}
+
+#define STATS_FIELD_COUNT 20
+
+// Counters in export order, so the CSV and JSON exports always agree
+struct StatsField {
+	const char* name;
+	long long value;
+};
+
+static int StatsFields(const SolverStats& stats, StatsField* fields) {
+	int count = 0;
+	fields[count++] = { "steps", stats.steps };
+	fields[count++] = { "step_ns", stats.step_ns };
+	fields[count++] = { "max_step_ns", stats.max_step_ns };
+	fields[count++] = { "floodfills", stats.TotalFloodfills() };
+	fields[count++] = { "floodfills_run_start", stats.floodfills[FLOODFILL_RUN_START] };
+	fields[count++] = { "floodfills_new_walls", stats.floodfills[FLOODFILL_NEW_WALLS] };
+	fields[count++] = { "floodfills_target_change", stats.floodfills[FLOODFILL_TARGET_CHANGE] };
+	fields[count++] = { "floodfills_other", stats.floodfills[FLOODFILL_OTHER] };
+	fields[count++] = { "incremental_floodfills", stats.incremental_floodfills };
+	fields[count++] = { "queue_pushes", stats.queue_pushes };
+	fields[count++] = { "queue_pops", stats.queue_pops };
+	fields[count++] = { "expansions", stats.expansions };
+	fields[count++] = { "path_updates", stats.path_updates };
+	fields[count++] = { "path_length_total", stats.path_length_total };
+	fields[count++] = { "max_path_length", stats.max_path_length };
+	fields[count++] = { "target_updates", stats.target_updates };
+	fields[count++] = { "path_searches", stats.path_searches };
+	fields[count++] = { "search_expansions", stats.search_expansions };
+	fields[count++] = { "flood_cache_hits", stats.flood_cache_hits };
+	fields[count++] = { "flood_cache_misses", stats.flood_cache_misses };
+	return count;
+}
+
+std::string SolverStatsCsvHeader() {
+	StatsField fields[STATS_FIELD_COUNT];
+	int count = StatsFields(SolverStats(), fields);
+
+	std::string header;
+	for (int i = 0; i < count; i++) {
+		header += (i > 0 ? "," : "") + std::string(fields[i].name);
+	}
+	return header;
+}
+
+std::string SolverStatsToCsv(const SolverStats& stats) {
+	StatsField fields[STATS_FIELD_COUNT];
+	int count = StatsFields(stats, fields);
+
+	std::string row;
+	for (int i = 0; i < count; i++) {
+		row += (i > 0 ? "," : "") + std::to_string(fields[i].value);
+	}
+	return row;
+}
+
+std::string SolverStatsToJson(const SolverStats& stats) {
+	StatsField fields[STATS_FIELD_COUNT];
+	int count = StatsFields(stats, fields);
+
+	std::string json = "{";
+	for (int i = 0; i < count; i++) {
+		json += (i > 0 ? ", \"" : "\"") + std::string(fields[i].name) + "\": " + std::to_string(fields[i].value);
+	}
+	return json + "}";
+}
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "work_stealing.hpp"
+
+// Indices [next, end) left for a worker. Each range is on its own cache line, so workers
+// taking indices from their own range don't slow each other down.
+struct alignas(64) WorkRange {
+	std::mutex lock;
+	int next = 0;
+	int end = 0;
+};
+
+// Take the next index of the range, returns false if it is empty
+static bool TakeIndex(WorkRange& range, int* index) {
+	std::lock_guard<std::mutex> guard(range.lock);
+	if (range.next >= range.end) return false;
+	*index = range.next++;
+	return true;
+}
+
+// Move the back half of the victim's remaining indices to the (empty) thief's range.
+// Returns false if the victim had nothing left.
+static bool StealHalf(WorkRange& victim, WorkRange& thief) {
+	int next, end;
+	{
+		std::lock_guard<std::mutex> guard(victim.lock);
+		int remaining = victim.end - victim.next;
+		if (remaining <= 0) return false;
+		end = victim.end;
+		next = end - (remaining + 1) / 2;
+		victim.end = next;
+	}
+
+	std::lock_guard<std::mutex> guard(thief.lock);
+	thief.next = next;
+	thief.end = end;
+	return true;
+}
+
+static void RunWorker(WorkRange* ranges, int thread_count, int worker,
+	const std::function<void(int index, int worker)>& task) {
+	while (true) {
+		int index;
+		if (TakeIndex(ranges[worker], &index)) {
+			task(index, worker);
+			continue;
+		}
+
+		// Out of work, look for a worker that still has some, starting with the next one
+		bool stole = false;
+		for (int i = 1; i < thread_count && !stole; i++) {
+			stole = StealHalf(ranges[(worker + i) % thread_count], ranges[worker]);
+		}
+		if (!stole) {
+			// Anything not taken yet is in the range of a worker that is still running
+			return;
+		}
+	}
+}
+
+void ParallelFor(int count, int thread_count, const std::function<void(int index, int worker)>& task) {
+	thread_count = std::max(1, std::min(thread_count, count));
+	if (thread_count == 1) {
+		for (int i = 0; i < count; i++) {
+			task(i, 0);
+		}
+		return;
+	}
+
+	std::unique_ptr<WorkRange[]> ranges(new WorkRange[thread_count]);
+	for (int i = 0; i < thread_count; i++) {
+		ranges[i].next = (int)((long long)count * i / thread_count);
+		ranges[i].end = (int)((long long)count * (i + 1) / thread_count);
+	}
+
+	std::vector<std::thread> threads;
+	for (int i = 1; i < thread_count; i++) {
+		threads.emplace_back(RunWorker, ranges.get(), thread_count, i, std::cref(task));
+	}
+	RunWorker(ranges.get(), thread_count, 0, task);
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+}
+
+int DefaultThreadCount() {
+	return std::max(1, (int)std::thread::hardware_concurrency());
+}
@@ -0,0 +1,512 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "log.hpp"
+#include "maze.hpp"
+#include "maze_generator.hpp"
+#include "solver/diagonal_solver.hpp"
+#include "solver/simple_solver.hpp"
+#include "work_stealing.hpp"
+
+// Microbenchmarks for the floodfill and path tracing of both solvers.
+//
+// For every maze, each solver is stepped to a few seeded points of its exploration run,
+// and Floodfill(false), Floodfill(true) and UpdatePath() are timed on those snapshots, as well as
+// compiling the traced path into motion primitives and estimating its run time ("RunTime()").
+// The flood cache is off for these, and Floodfill(cached) times a floodfill taken from it instead.
+// The simple solver is timed with both floodfill backends ("simple" and "simple-bb").
+// The timed calls must not allocate: the benchmark fails if any of them do.
+//
+// Usage: micromouse_bench [--iterations N] [--warmup N] [--snapshots N] [--seed N]
+//                         [--solver diagonal|simple] [--max-steps N] [--load [--threads N]]
+//                         [--search] [--generate [--size RxC]] file.maz...
+//
+// --solver only benchmarks one of the solvers, and --max-steps limits how far into the run
+// snapshots are taken, which keeps large mazes manageable.
+//
+// --load benchmarks loading the files instead: each file with LoadFromFile(), then all of them
+// at once with LoadMazeFiles() on --threads threads (all cores by default).
+//
+// --search benchmarks the start-to-goal query on the maze a finished run knows, as a full floodfill
+// (Floodfill(), which also traces the path) against the A* search (FindPath()), with the nodes each expands per call.
+//
+// --generate benchmarks MazeGenerator::Generate() instead, for each algorithm at --size (16x16 by default),
+// with a new seed every call. No files are needed.
+
+#define DEFAULT_ITERATIONS 200
+#define DEFAULT_WARMUP 20
+#define DEFAULT_SNAPSHOTS 8
+#define DEFAULT_SEED 12345
+#define DEFAULT_MAX_STEPS 100000
+
+typedef std::chrono::steady_clock Clock;
+
+// Heap allocations made by this process so far, counted by the global operator new below.
+// Worker threads allocate too (see BenchLoad), so the count is atomic.
+static std::atomic<long long> allocation_count(0);
+
+void* operator new(size_t size) {
+	allocation_count.fetch_add(1, std::memory_order_relaxed);
+	void* p = malloc(size ? size : 1);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+struct BenchConfig {
+	int iterations;
+	int warmup;
+	int snapshots;
+	unsigned int seed;
+	int max_steps;
+	bool bench_simple;
+	bool bench_diagonal;
+	int threads;
+};
+
+struct BenchResult {
+	double p50_ns;
+	double p99_ns;
+	double calls_per_sec;
+	long long allocations;
+};
+
+void PrintUsage(const char* program) {
+	std::cout << "Usage: " << program
+		<< " [--iterations N] [--warmup N] [--snapshots N] [--seed N] [--solver diagonal|simple] [--max-steps N]"
+		<< " [--load [--threads N]] [--search] [--generate [--size RxC]] file.maz..." << std::endl;
+}
+
+void IgnoreLog(const std::string&) { }
+
+void PrintError(const std::string& msg) {
+	std::cerr << msg << std::endl;
+}
+
+double Percentile(std::vector<double>& sorted_samples, double p) {
+	int i = (int)(p * (sorted_samples.size() - 1) + 0.5);
+	return sorted_samples[i];
+}
+
+// Time every call of op individually, after some untimed warm-up calls.
+// Returns the number of heap allocations made by the timed calls.
+long long Measure(const BenchConfig& config, std::function<void()> op, std::vector<double>& samples) {
+	for (int i = 0; i < config.warmup; i++) {
+		op();
+	}
+
+	// Grow the sample buffer before timing, so only op's own allocations are counted
+	samples.reserve(samples.size() + config.iterations);
+
+	long long allocations = 0;
+	for (int i = 0; i < config.iterations; i++) {
+		long long allocations_before = allocation_count.load(std::memory_order_relaxed);
+		Clock::time_point start = Clock::now();
+		op();
+		Clock::time_point end = Clock::now();
+		allocations += allocation_count.load(std::memory_order_relaxed) - allocations_before;
+		samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+	}
+	return allocations;
+}
+
+BenchResult Summarize(std::vector<double>& samples, long long allocations) {
+	std::sort(samples.begin(), samples.end());
+
+	double total_ns = 0.0;
+	for (double s : samples) {
+		total_ns += s;
+	}
+
+	return {
+		Percentile(samples, 0.50),
+		Percentile(samples, 0.99),
+		total_ns > 0.0 ? samples.size() * 1e9 / total_ns : 0.0,
+		allocations
+	};
+}
+
+// Returns the number of heap allocations made by the timed calls
+template <typename T>
+long long BenchSolver(const char* solver_name, Maze* maze, Point starting_coord, const BenchConfig& config,
+	std::string& maze_name, std::function<void(T&)> configure = nullptr) {
+	// Count the steps of a full run, so snapshots can be spread across it
+	T solver = T(maze, starting_coord);
+	if (configure) {
+		configure(solver);
+	}
+	int total_steps = 0;
+	while (!solver.IsFinished() && total_steps < config.max_steps) {
+		solver.Step();
+		total_steps++;
+	}
+
+	std::mt19937 rng(config.seed);
+	std::uniform_int_distribution<int> step_dist(0, std::max(0, total_steps - 1));
+
+	// Repeated floodfills of an unchanged maze would only be (empty) repairs or cache hits, so time full ones
+	solver.incremental_floodfill = false;
+	solver.cache_floodfills = false;
+
+	RunCompiler compiler;
+	MotionModel motion_model;
+	std::vector<Waypoint> waypoints;
+	std::vector<MotionPrimitive> primitives;
+
+	std::vector<double> samples[5];
+	long long allocations[5] = { 0, 0, 0, 0, 0 };
+	for (int s = 0; s < config.snapshots; s++) {
+		int steps = step_dist(rng);
+		solver.Reset();
+		for (int i = 0; i < steps && !solver.IsFinished(); i++) {
+			solver.Step();
+		}
+
+		allocations[0] += Measure(config, [&]() { solver.Floodfill(false); }, samples[0]);
+		allocations[1] += Measure(config, [&]() { solver.Floodfill(true); }, samples[1]);
+
+		// Trace the path on the regular floodfill values
+		solver.Floodfill(false);
+		allocations[2] += Measure(config, [&]() { solver.UpdatePath(); }, samples[2]);
+		allocations[3] += Measure(config, [&]() {
+			solver.PathWaypoints(waypoints);
+			if (compiler.Compile(waypoints, primitives)) {
+				motion_model.RunTime(primitives);
+			}
+		}, samples[3]);
+
+		// Every call after the first finds the same known walls and targets in the cache
+		solver.cache_floodfills = true;
+		solver.Floodfill(false);
+		allocations[4] += Measure(config, [&]() { solver.Floodfill(false); }, samples[4]);
+		solver.cache_floodfills = false;
+	}
+
+	const char* op_names[5] = { "Floodfill(false)", "Floodfill(true)", "UpdatePath()", "RunTime()", "Floodfill(cached)" };
+	long long total_allocations = 0;
+	for (int i = 0; i < 5; i++) {
+		BenchResult result = Summarize(samples[i], allocations[i]);
+		total_allocations += result.allocations;
+		printf(
+			"%-44s %-9s %-17s %10.0f %10.0f %14.0f %7lld\n",
+			maze_name.c_str(),
+			solver_name,
+			op_names[i],
+			result.p50_ns,
+			result.p99_ns,
+			result.calls_per_sec,
+			result.allocations
+		);
+	}
+	return total_allocations;
+}
+
+// Time the start-to-goal query of a finished run both ways: flooding from scratch, and FindPath().
+// Returns the number of heap allocations made by the timed calls, or -1 if the run doesn't finish.
+template <typename T, typename P>
+long long BenchSearch(const char* solver_name, Maze* maze, Point starting_coord, const BenchConfig& config,
+	std::string& maze_name) {
+	T solver = T(maze, starting_coord);
+	for (int i = 0; i < config.max_steps && !solver.IsFinished(); i++) {
+		solver.Step();
+	}
+	if (!solver.IsFinished()) {
+		return -1;
+	}
+
+	// A finished run is back at the start with the goals as its targets, so a floodfill answers the same query
+	solver.incremental_floodfill = false;
+	solver.cache_floodfills = false;
+	P path;
+	long long total_allocations = 0;
+	for (int visited_only = 1; visited_only >= 0; visited_only--) {
+		for (int search = 0; search < 2; search++) {
+			std::vector<double> samples;
+			long long expanded_before = search ? solver.stats.search_expansions : solver.stats.expansions;
+			long long allocations = Measure(config, [&]() {
+				if (search) {
+					solver.FindPath(starting_coord, maze->goals, visited_only, path);
+				} else {
+					solver.Floodfill(visited_only);
+				}
+			}, samples);
+			long long expanded = (search ? solver.stats.search_expansions : solver.stats.expansions) - expanded_before;
+
+			BenchResult result = Summarize(samples, allocations);
+			total_allocations += allocations;
+			std::string op_name = std::string(search ? "FindPath(" : "Floodfill(") + (visited_only ? "true)" : "false)");
+			printf(
+				"%-44s %-9s %-17s %10.0f %10.0f %14.0f %9lld\n",
+				maze_name.c_str(),
+				solver_name,
+				op_name.c_str(),
+				result.p50_ns,
+				result.p99_ns,
+				result.calls_per_sec,
+				expanded / (config.warmup + config.iterations)
+			);
+		}
+	}
+	return total_allocations;
+}
+
+// Time loading every file on its own, then all of them as a parallel batch. Returns the number of failures.
+int BenchLoad(std::vector<std::string>& filenames, const BenchConfig& config) {
+	printf("%-44s %-9s %-17s %10s %10s %14s %7s\n", "maze", "", "operation", "p50 (ns)", "p99 (ns)", "calls/s", "allocs");
+
+	Maze maze = Maze();
+	int failures = 0;
+	for (std::string& filename : filenames) {
+		Point starting_coord = Point(0, 0);
+		if (!maze.LoadFromFile(filename, &starting_coord)) {
+			failures++;
+			continue;
+		}
+
+		std::vector<double> samples;
+		long long allocations = Measure(config, [&]() { maze.LoadFromFile(filename, &starting_coord); }, samples);
+		BenchResult result = Summarize(samples, allocations);
+		std::string maze_name = filename.substr(filename.find_last_of("/\\") + 1)
+			+ " (" + std::to_string(maze.Rows()) + "x" + std::to_string(maze.Cols()) + ")";
+		printf(
+			"%-44s %-9s %-17s %10.0f %10.0f %14.0f %7lld\n",
+			maze_name.c_str(),
+			"",
+			"LoadFromFile()",
+			result.p50_ns,
+			result.p99_ns,
+			result.calls_per_sec,
+			result.allocations
+		);
+	}
+
+	// The batch reloads into the same mazes every iteration, like the single file loads above
+	std::vector<Maze> mazes;
+	std::vector<Point> starting_coords;
+	std::vector<MazeFileError> errors;
+	LoadMazeFiles(filenames, mazes, starting_coords, errors, config.threads);
+	Clock::time_point start = Clock::now();
+	for (int i = 0; i < config.iterations; i++) {
+		LoadMazeFiles(filenames, mazes, starting_coords, errors, config.threads);
+	}
+	double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	printf(
+		"\nLoadMazeFiles(): %d x %zu file(s) in %.3f ms on %d thread(s), %.0f mazes/s\n",
+		config.iterations,
+		filenames.size(),
+		ms,
+		config.threads,
+		ms > 0.0 ? config.iterations * filenames.size() * 1000.0 / ms : 0.0
+	);
+	return failures;
+}
+
+// Time generating mazes with every algorithm. Returns the number of heap allocations made by the timed calls.
+long long BenchGenerate(const BenchConfig& config, int rows, int cols) {
+	printf("%-44s %-9s %-17s %10s %10s %14s %7s\n", "maze", "", "algorithm", "p50 (ns)", "p99 (ns)", "calls/s", "allocs");
+
+	std::string maze_name = std::to_string(rows) + "x" + std::to_string(cols);
+	MazeGenerator generator;
+	Maze maze = Maze(rows, cols);
+	Point starting_coord = Point(0, 0);
+	long long total_allocations = 0;
+	for (int i = 0; i < MAZE_ALGORITHM_COUNT; i++) {
+		MazeAlgorithm algorithm = (MazeAlgorithm)i;
+		uint64_t seed = config.seed;
+		std::vector<double> samples;
+		long long allocations = Measure(config, [&]() {
+			generator.Generate(&maze, rows, cols, algorithm, seed++, &starting_coord);
+		}, samples);
+		BenchResult result = Summarize(samples, allocations);
+		total_allocations += allocations;
+		printf(
+			"%-44s %-9s %-17s %10.0f %10.0f %14.0f %7lld\n",
+			maze_name.c_str(),
+			"",
+			MazeAlgorithmName(algorithm),
+			result.p50_ns,
+			result.p99_ns,
+			result.calls_per_sec,
+			result.allocations
+		);
+	}
+	return total_allocations;
+}
+
+int main(int argc, char** argv) {
+	BenchConfig config = {
+		DEFAULT_ITERATIONS, DEFAULT_WARMUP, DEFAULT_SNAPSHOTS, DEFAULT_SEED, DEFAULT_MAX_STEPS, true, true,
+		DefaultThreadCount()
+	};
+	std::vector<std::string> filenames;
+	bool load = false;
+	bool search = false;
+	bool generate = false;
+	int generated_rows = 16;
+	int generated_cols = 16;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--iterations") && i + 1 < argc) {
+			config.iterations = std::max(1, atoi(argv[++i]));
+		} else if (!strcmp(argv[i], "--warmup") && i + 1 < argc) {
+			config.warmup = std::max(0, atoi(argv[++i]));
+		} else if (!strcmp(argv[i], "--snapshots") && i + 1 < argc) {
+			config.snapshots = std::max(1, atoi(argv[++i]));
+		} else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+			config.seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+		} else if (!strcmp(argv[i], "--solver") && i + 1 < argc) {
+			std::string type = argv[++i];
+			if (type != "diagonal" && type != "simple") {
+				std::cout << "Unknown solver type: " << type << std::endl;
+				return 1;
+			}
+			config.bench_simple = type == "simple";
+			config.bench_diagonal = type == "diagonal";
+		} else if (!strcmp(argv[i], "--max-steps") && i + 1 < argc) {
+			config.max_steps = std::max(1, atoi(argv[++i]));
+		} else if (!strcmp(argv[i], "--generate")) {
+			generate = true;
+		} else if (!strcmp(argv[i], "--size") && i + 1 < argc) {
+			if (sscanf(argv[++i], "%dx%d", &generated_rows, &generated_cols) != 2
+				|| generated_rows < 1 || generated_rows > MAZE_MAX_SIZE
+				|| generated_cols < 1 || generated_cols > MAZE_MAX_SIZE) {
+				std::cout << "Invalid maze size: " << argv[i] << std::endl;
+				return 1;
+			}
+		} else if (!strcmp(argv[i], "--search")) {
+			search = true;
+		} else if (!strcmp(argv[i], "--load")) {
+			load = true;
+		} else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+			config.threads = std::max(1, atoi(argv[++i]));
+		} else if (!strcmp(argv[i], "--help") || !strcmp(argv[i], "-h")) {
+			PrintUsage(argv[0]);
+			return 0;
+		} else if (argv[i][0] == '-') {
+			std::cout << "Unknown option: " << argv[i] << std::endl;
+			PrintUsage(argv[0]);
+			return 1;
+		} else {
+			filenames.push_back(argv[i]);
+		}
+	}
+
+	if (filenames.empty() && !generate) {
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	SetLogHandlers(IgnoreLog, PrintError);
+
+	if (generate) {
+		printf("iterations: %d, warmup: %d, seed: %u\n\n", config.iterations, config.warmup, config.seed);
+		long long allocations = BenchGenerate(config, generated_rows, generated_cols);
+		if (allocations > 0) {
+			std::cerr << allocations << " heap allocation(s) in timed calls" << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	if (load) {
+		printf("iterations: %d, warmup: %d\n\n", config.iterations, config.warmup);
+		return BenchLoad(filenames, config) == 0 ? 0 : 1;
+	}
+
+	if (search) {
+		printf("iterations: %d, warmup: %d, max steps: %d\n\n", config.iterations, config.warmup, config.max_steps);
+		printf(
+			"%-44s %-9s %-17s %10s %10s %14s %9s\n",
+			"maze", "solver", "operation", "p50 (ns)", "p99 (ns)", "calls/s", "expanded"
+		);
+
+		Maze maze = Maze();
+		int failures = 0;
+		for (std::string& filename : filenames) {
+			Point starting_coord = Point(0, 0);
+			if (!maze.LoadFromFile(filename, &starting_coord)) {
+				failures++;
+				continue;
+			}
+
+			std::string maze_name = filename.substr(filename.find_last_of("/\\") + 1)
+				+ " (" + std::to_string(maze.Rows()) + "x" + std::to_string(maze.Cols()) + ")";
+			long long allocations[2] = { 0, 0 };
+			if (config.bench_simple) {
+				allocations[0] = BenchSearch<SimpleSolver, std::vector<Point>>("simple", &maze, starting_coord, config, maze_name);
+			}
+			if (config.bench_diagonal) {
+				allocations[1] = BenchSearch<DiagonalSolver, std::vector<PathNode>>("diagonal", &maze, starting_coord, config, maze_name);
+			}
+			if (allocations[0] < 0 || allocations[1] < 0) {
+				std::cerr << maze_name << ": the run didn't finish within " << config.max_steps << " steps" << std::endl;
+				failures++;
+			} else if (allocations[0] + allocations[1] > 0) {
+				std::cerr << maze_name << ": " << allocations[0] + allocations[1] << " heap allocation(s) in timed calls" << std::endl;
+				failures++;
+			}
+		}
+		return failures == 0 ? 0 : 1;
+	}
+
+	printf(
+		"iterations: %d, warmup: %d, snapshots: %d, seed: %u, max steps: %d\n\n",
+		config.iterations,
+		config.warmup,
+		config.snapshots,
+		config.seed,
+		config.max_steps
+	);
+	printf(
+		"%-44s %-9s %-17s %10s %10s %14s %7s\n",
+		"maze", "solver", "operation", "p50 (ns)", "p99 (ns)", "calls/s", "allocs"
+	);
+
+	Maze maze = Maze();
+	int failures = 0;
+	for (std::string& filename : filenames) {
+		Point starting_coord = Point(0, 0);
+		if (!maze.LoadFromFile(filename, &starting_coord)) {
+			failures++;
+			continue;
+		}
+
+		std::string maze_name = filename.substr(filename.find_last_of("/\\") + 1)
+			+ " (" + std::to_string(maze.Rows()) + "x" + std::to_string(maze.Cols()) + ")";
+		long long allocations = 0;
+		if (config.bench_simple) {
+			allocations += BenchSolver<SimpleSolver>("simple", &maze, starting_coord, config, maze_name);
+			if (maze.Cols() <= SIMPLE_BITBOARD_MAX_COLS) {
+				allocations += BenchSolver<SimpleSolver>("simple-bb", &maze, starting_coord, config, maze_name,
+					[](SimpleSolver& solver) { solver.floodfill_backend = SIMPLE_FF_BITBOARD; });
+			}
+		}
+		if (config.bench_diagonal) {
+			allocations += BenchSolver<DiagonalSolver>("diagonal", &maze, starting_coord, config, maze_name);
+		}
+		if (allocations > 0) {
+			std::cerr << maze_name << ": " << allocations << " heap allocation(s) in timed calls" << std::endl;
+			failures++;
+		}
+	}
+
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "log.hpp"
+#include "maze.hpp"
+#include "maze_archive.hpp"
+
+// Converts maze collections in bulk: packs mazes into a .mza archive, for the headless runner to read
+// without opening a file per maze, and/or writes each of them out as this project's .maz files.
+//
+// Usage: micromouse_convert [-o out.mza] [-d maz_dir] file...
+//
+// Inputs can be maze files of any format Maze::LoadFromFile() detects (.maz, the classic binary .maz,
+// .num and ASCII text mazes) or other archives, whose mazes are all copied over.
+
+void PrintUsage(const char* program) {
+	std::cout << "Usage: " << program << " [-o out.mza] [-d maz_dir] file..." << std::endl;
+}
+
+void IgnoreLog(const std::string&) { }
+
+void PrintError(const std::string& msg) {
+	std::cerr << msg << std::endl;
+}
+
+bool EndsWith(const std::string& s, const std::string& suffix) {
+	return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// File name without its directory and extension
+std::string BaseName(const std::string& filename) {
+	std::string name = filename.substr(filename.find_last_of("/\\") + 1);
+	return name.substr(0, name.find_last_of('.'));
+}
+
+int main(int argc, char** argv) {
+	std::string output;
+	std::string maz_dir;
+	std::vector<std::string> filenames;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+			output = argv[++i];
+		} else if (!strcmp(argv[i], "-d") && i + 1 < argc) {
+			maz_dir = argv[++i];
+		} else if (!strcmp(argv[i], "--help") || !strcmp(argv[i], "-h")) {
+			PrintUsage(argv[0]);
+			return 0;
+		} else if (argv[i][0] == '-') {
+			std::cout << "Unknown option: " << argv[i] << std::endl;
+			PrintUsage(argv[0]);
+			return 1;
+		} else {
+			filenames.push_back(argv[i]);
+		}
+	}
+
+	if ((output.empty() && maz_dir.empty()) || filenames.empty()) {
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	SetLogHandlers(IgnoreLog, PrintError);
+
+	MazeArchiveWriter writer;
+	Maze maze = Maze();
+	Point starting_coord = Point(0, 0);
+	int failures = 0;
+	int written = 0;
+
+	// Add a maze to the archive and write its .maz file, as asked
+	auto add = [&](const std::string& name) {
+		if (!output.empty()) {
+			writer.Add(maze, starting_coord);
+		}
+		if (!maz_dir.empty()) {
+			if (maze.SaveToFile(maz_dir + "/" + name + ".maz", starting_coord)) {
+				written++;
+			} else {
+				failures++;
+			}
+		}
+	};
+
+	for (std::string& filename : filenames) {
+		if (EndsWith(filename, ".mza")) {
+			MazeArchive archive;
+			if (!archive.Open(filename)) {
+				failures++;
+				continue;
+			}
+			for (int i = 0; i < archive.Count(); i++) {
+				if (archive.Load(i, &maze, &starting_coord)) {
+					add(BaseName(filename) + "_" + std::to_string(i));
+				} else {
+					std::cerr << "Invalid maze " << i << " in archive: " << filename << std::endl;
+					failures++;
+				}
+			}
+		} else if (maze.LoadFromFile(filename, &starting_coord)) {
+			add(BaseName(filename));
+		} else {
+			failures++;
+		}
+	}
+
+	if (!output.empty()) {
+		if (!writer.SaveToFile(output)) {
+			return 1;
+		}
+		std::cout << "Packed " << writer.Count() << " maze(s) into " << output << std::endl;
+	}
+	if (!maz_dir.empty()) {
+		std::cout << "Wrote " << written << " .maz file(s) to " << maz_dir << std::endl;
+	}
+
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,536 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "log.hpp"
+#include "point.hpp"
+#include "maze.hpp"
+#include "maze_archive.hpp"
+#include "maze_generator.hpp"
+#include "solver/diagonal_solver.hpp"
+#include "solver/simple_solver.hpp"
+#include "work_stealing.hpp"
+
+// Headless batch runner: solves maze files (see Maze::LoadFromFile()) and .mza archives without opening a window.
+//
+// Usage: micromouse_headless [--solver diagonal|simple] [--runs N] [--max-steps N]
+//                            [--full-floodfill] [--astar] [--cache] [--backend queue|bitboard] [--verify]
+//                            [--sweep] [--threads N] [--generate N [--algorithm NAME] [--size RxC] [--seed N]]
+//                            [--stats out.csv|out.json] [--fast-run] [--motion SPEC] file.maz|file.mza...
+//
+// --full-floodfill disables incremental floodfill repair.
+// --astar finds the start-to-goal path of the target updates with A* (see FindPath()) instead of a floodfill.
+// --cache enables the flood cache (see FloodCache) and prints its hit rate.
+// --backend selects how the simple solver computes full floodfills.
+// --verify compares the floodfill values against a full floodfill after every step.
+// --sweep solves every maze from each of its legal starting corners with both solvers
+// (or only the one given by --solver).
+// --threads sets how many solves run at once, by default 1, or one per core with --sweep.
+// --generate solves N generated mazes (after any files), with seeds counting up from --seed.
+// --algorithm picks the generator (backtracker, kruskal, braid, loops or competition, the default),
+// and --size the maze size (16x16 by default).
+// --stats writes the solver counters of every run (see SolverStats) to a CSV file, or JSON if the
+// file name ends in .json.
+// --fast-run compiles the solution path of each finished run into motion primitives (see RunCompiler)
+// and reports the estimated time to drive it, and for the diagonal solver also the time of the fast run
+// planned for the least time (see DiagonalSolver::PlanFastRun()).
+// --motion changes the motion profile the times are estimated with, like "max_speed=3,turn90_speed=1.1"
+// (see ParseMotionProfile()).
+//
+// Every maze is solved independently, so they are spread over the threads and the results
+// are reported in their original order. Mazes in archives are read, and generated mazes
+// generated, as they are solved.
+
+#define DEFAULT_MAX_STEPS 100000
+#define DEFAULT_GENERATED_SIZE 16
+
+struct RunResult {
+	int steps;
+	int floodfills;
+	double ms;
+	bool finished;
+	int mismatches;
+};
+
+// A maze to solve from each of its starting coords, with each solver
+struct SolveJob {
+	int file; // Index of the .maz file or archive, or -1 for generated mazes
+	int archive_index; // Maze within the archive or generated maze number, or -1 for .maz files
+};
+
+// A run of a solver from a starting coord, as reported
+struct RunRow {
+	Point starting_coord;
+	bool diagonal;
+	int run;
+	RunResult result;
+	SolverStats stats;
+	float solution_time; // Estimated seconds, or -1 without --fast-run
+	float fast_run_time; // Diagonal solver only
+	int solution_primitives;
+};
+
+// Each thread solves on its own copy of the maze, with its own solvers
+struct SolveWorker {
+	Maze maze;
+	DiagonalSolver diagonal_solver = DiagonalSolver(&maze, Point(0, 0));
+	SimpleSolver simple_solver = SimpleSolver(&maze, Point(0, 0));
+	MazeGenerator generator;
+	RunCompiler compiler;
+	MotionModel motion_model;
+	std::vector<Waypoint> waypoints;
+	std::vector<MotionPrimitive> primitives;
+};
+
+void PrintUsage(const char* program) {
+	std::cout << "Usage: " << program
+		<< " [--solver diagonal|simple] [--runs N] [--max-steps N] [--full-floodfill] [--astar] [--cache] [--backend queue|bitboard]"
+		<< " [--verify] [--sweep] [--threads N] [--generate N [--algorithm NAME] [--size RxC] [--seed N]]"
+		<< " [--stats out.csv|out.json] [--fast-run] [--motion SPEC] file.maz|file.mza..."
+		<< std::endl;
+}
+
+void IgnoreLog(const std::string&) { }
+
+bool EndsWith(const std::string& s, const std::string& suffix) {
+	return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+void PrintError(const std::string& msg) {
+	std::cerr << msg << std::endl;
+}
+
+std::string JsonString(const std::string& s) {
+	std::string json = "\"";
+	for (char c : s) {
+		if (c == '"' || c == '\\') {
+			json += '\\';
+		}
+		json += c;
+	}
+	return json + "\"";
+}
+
+std::string CsvField(const std::string& s) {
+	if (s.find_first_of(",\"\n") == std::string::npos) {
+		return s;
+	}
+
+	std::string csv = "\"";
+	for (char c : s) {
+		csv += c == '"' ? std::string("\"\"") : std::string(1, c);
+	}
+	return csv + "\"";
+}
+
+// A corner cell is a legal start if, like the start of a competition maze, it has a single open side
+bool IsLegalStart(Maze& maze, Point cell) {
+	int walls = maze.WallAt(true, cell)
+		+ maze.WallAt(true, cell + Point(0, 1))
+		+ maze.WallAt(false, cell)
+		+ maze.WallAt(false, cell + Point(1, 0));
+	return walls == 3 && std::find(maze.goals.begin(), maze.goals.end(), cell) == maze.goals.end();
+}
+
+// The legal starting corners of the maze, or the file's starting coord if none of them are
+std::vector<Point> StartingCorners(Maze& maze, Point file_starting_coord) {
+	Point corners[4] = {
+		Point(0, 0),
+		Point((int16_t)(maze.Cols() - 1), 0),
+		Point(0, (int16_t)(maze.Rows() - 1)),
+		Point((int16_t)(maze.Cols() - 1), (int16_t)(maze.Rows() - 1))
+	};
+
+	std::vector<Point> starts;
+	for (Point& corner : corners) {
+		if (IsLegalStart(maze, corner) && std::find(starts.begin(), starts.end(), corner) == starts.end()) {
+			starts.push_back(corner);
+		}
+	}
+	if (starts.empty()) {
+		starts.push_back(file_starting_coord);
+	}
+	return starts;
+}
+
+// Step the solver until the run is finished or the step limit is hit
+RunResult Run(Solver* solver, bool soft_reset, int max_steps, bool verify) {
+	RunResult result = { 0, 0, 0.0, false, 0 };
+
+	auto start = std::chrono::steady_clock::now();
+	int floodfills_before = soft_reset ? solver->floodfill_count : 0;
+	if (soft_reset) {
+		solver->SoftReset();
+	} else {
+		solver->Reset();
+	}
+	if (verify && !solver->VerifyFloodfill()) {
+		result.mismatches++;
+	}
+
+	while (!solver->IsFinished() && result.steps < max_steps) {
+		solver->Step();
+		result.steps++;
+
+		if (verify && !solver->VerifyFloodfill()) {
+			result.mismatches++;
+		}
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	result.floodfills = solver->floodfill_count - floodfills_before;
+	result.ms = std::chrono::duration<double, std::milli>(end - start).count();
+	result.finished = solver->IsFinished();
+	return result;
+}
+
+int main(int argc, char** argv) {
+	bool run_diagonal_solver = true;
+	bool run_simple_solver = false;
+	bool solver_given = false;
+	int runs = 1;
+	int max_steps = DEFAULT_MAX_STEPS;
+	bool incremental_floodfill = true;
+	bool astar_target_paths = false;
+	bool cache_floodfills = false;
+	bool verify = false;
+	bool sweep = false;
+	int threads = 0;
+	SimpleFloodfillBackend backend = SIMPLE_FF_QUEUE;
+	int generated_count = 0;
+	MazeAlgorithm algorithm = MAZE_ALGORITHM_COMPETITION;
+	int generated_rows = DEFAULT_GENERATED_SIZE;
+	int generated_cols = DEFAULT_GENERATED_SIZE;
+	uint64_t seed = 0;
+	std::string stats_filename;
+	bool fast_run = false;
+	MotionProfile motion_profile = DefaultMotionProfile();
+	std::vector<std::string> filenames;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--solver") && i + 1 < argc) {
+			std::string type = argv[++i];
+			if (type != "diagonal" && type != "simple") {
+				std::cout << "Unknown solver type: " << type << std::endl;
+				return 1;
+			}
+			run_diagonal_solver = type == "diagonal";
+			run_simple_solver = type == "simple";
+			solver_given = true;
+		} else if (!strcmp(argv[i], "--runs") && i + 1 < argc) {
+			runs = std::max(1, atoi(argv[++i]));
+		} else if (!strcmp(argv[i], "--max-steps") && i + 1 < argc) {
+			max_steps = std::max(1, atoi(argv[++i]));
+		} else if (!strcmp(argv[i], "--full-floodfill")) {
+			incremental_floodfill = false;
+		} else if (!strcmp(argv[i], "--astar")) {
+			astar_target_paths = true;
+		} else if (!strcmp(argv[i], "--cache")) {
+			cache_floodfills = true;
+		} else if (!strcmp(argv[i], "--backend") && i + 1 < argc) {
+			std::string type = argv[++i];
+			if (type == "queue") {
+				backend = SIMPLE_FF_QUEUE;
+			} else if (type == "bitboard") {
+				backend = SIMPLE_FF_BITBOARD;
+			} else {
+				std::cout << "Unknown floodfill backend: " << type << std::endl;
+				return 1;
+			}
+		} else if (!strcmp(argv[i], "--verify")) {
+			verify = true;
+		} else if (!strcmp(argv[i], "--sweep")) {
+			sweep = true;
+		} else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+			threads = std::max(1, atoi(argv[++i]));
+		} else if (!strcmp(argv[i], "--generate") && i + 1 < argc) {
+			generated_count = std::max(0, atoi(argv[++i]));
+		} else if (!strcmp(argv[i], "--algorithm") && i + 1 < argc) {
+			if (!ParseMazeAlgorithm(argv[++i], &algorithm)) {
+				std::cout << "Unknown maze algorithm: " << argv[i] << std::endl;
+				return 1;
+			}
+		} else if (!strcmp(argv[i], "--size") && i + 1 < argc) {
+			if (sscanf(argv[++i], "%dx%d", &generated_rows, &generated_cols) != 2
+				|| generated_rows < 1 || generated_rows > MAZE_MAX_SIZE
+				|| generated_cols < 1 || generated_cols > MAZE_MAX_SIZE) {
+				std::cout << "Invalid maze size: " << argv[i] << std::endl;
+				return 1;
+			}
+		} else if (!strcmp(argv[i], "--stats") && i + 1 < argc) {
+			stats_filename = argv[++i];
+		} else if (!strcmp(argv[i], "--fast-run")) {
+			fast_run = true;
+		} else if (!strcmp(argv[i], "--motion") && i + 1 < argc) {
+			if (!ParseMotionProfile(argv[++i], &motion_profile)) {
+				std::cout << "Invalid motion profile: " << argv[i] << std::endl;
+				return 1;
+			}
+		} else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+			seed = strtoull(argv[++i], nullptr, 10);
+		} else if (!strcmp(argv[i], "--help") || !strcmp(argv[i], "-h")) {
+			PrintUsage(argv[0]);
+			return 0;
+		} else if (argv[i][0] == '-') {
+			std::cout << "Unknown option: " << argv[i] << std::endl;
+			PrintUsage(argv[0]);
+			return 1;
+		} else {
+			filenames.push_back(argv[i]);
+		}
+	}
+
+	if (filenames.empty() && generated_count == 0) {
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	if (sweep && !solver_given) {
+		run_diagonal_solver = true;
+		run_simple_solver = true;
+	}
+	if (threads == 0) {
+		threads = sweep ? DefaultThreadCount() : 1;
+	}
+
+	// Load the .maz files up front (in parallel), and open the archives to read their mazes from as they are solved
+	SetLogHandlers(IgnoreLog, PrintError);
+	std::vector<std::string> maz_filenames;
+	for (std::string& filename : filenames) {
+		if (!EndsWith(filename, ".mza")) {
+			maz_filenames.push_back(filename);
+		}
+	}
+	std::vector<Maze> mazes;
+	std::vector<Point> maz_starting_coords;
+	std::vector<MazeFileError> maz_errors;
+	int failures = (int)maz_filenames.size()
+		- LoadMazeFiles(maz_filenames, mazes, maz_starting_coords, maz_errors, threads);
+
+	std::vector<std::unique_ptr<MazeArchive>> archives(filenames.size());
+	std::vector<Point> starting_coords(filenames.size(), Point(0, 0));
+	std::vector<int> file_mazes(filenames.size(), -1); // Index into mazes of each .maz file
+	std::vector<SolveJob> jobs;
+	int maz_count = 0;
+
+	for (size_t i = 0; i < filenames.size(); i++) {
+		if (EndsWith(filenames[i], ".mza")) {
+			archives[i].reset(new MazeArchive());
+			if (!archives[i]->Open(filenames[i])) {
+				failures++;
+				continue;
+			}
+			for (int j = 0; j < archives[i]->Count(); j++) {
+				jobs.push_back({ (int)i, j });
+			}
+		} else if (maz_errors[maz_count++] == MAZE_FILE_OK) {
+			file_mazes[i] = maz_count - 1;
+			starting_coords[i] = maz_starting_coords[maz_count - 1];
+			jobs.push_back({ (int)i, -1 });
+		}
+	}
+	for (int i = 0; i < generated_count; i++) {
+		jobs.push_back({ -1, i });
+	}
+
+	std::vector<std::unique_ptr<SolveWorker>> workers;
+	for (int i = 0; i < std::max(1, std::min(threads, (int)jobs.size())); i++) {
+		workers.emplace_back(new SolveWorker());
+		workers[i]->simple_solver.floodfill_backend = backend;
+		workers[i]->diagonal_solver.incremental_floodfill = incremental_floodfill;
+		workers[i]->diagonal_solver.motion_model.SetProfile(motion_profile);
+		workers[i]->motion_model.SetProfile(motion_profile);
+		workers[i]->simple_solver.incremental_floodfill = incremental_floodfill;
+		workers[i]->diagonal_solver.astar_target_paths = astar_target_paths;
+		workers[i]->simple_solver.astar_target_paths = astar_target_paths;
+		workers[i]->diagonal_solver.cache_floodfills = cache_floodfills;
+		workers[i]->simple_solver.cache_floodfills = cache_floodfills;
+	}
+
+	std::vector<std::vector<RunRow>> rows(jobs.size());
+	std::vector<char> invalid(jobs.size(), false); // Not vector<bool>, whose bits can't be set from several threads
+	auto start = std::chrono::steady_clock::now();
+	ParallelFor((int)jobs.size(), threads, [&](int index, int worker) {
+		SolveWorker& w = *workers[worker];
+		SolveJob& job = jobs[index];
+		Point starting_coord = Point(0, 0);
+		if (job.file < 0) {
+			w.generator.Generate(&w.maze, generated_rows, generated_cols, algorithm, seed + job.archive_index,
+				&starting_coord);
+		} else if (job.archive_index < 0) {
+			starting_coord = starting_coords[job.file];
+			w.maze = mazes[file_mazes[job.file]];
+		} else if (!archives[job.file]->Load(job.archive_index, &w.maze, &starting_coord)) {
+			invalid[index] = true;
+			return;
+		}
+
+		std::vector<Point> starts = { starting_coord };
+		if (sweep) {
+			starts = StartingCorners(w.maze, starting_coord);
+		}
+		for (Point& start : starts) {
+			for (int diagonal = 1; diagonal >= 0; diagonal--) {
+				if (diagonal ? !run_diagonal_solver : !run_simple_solver) continue;
+
+				Solver* solver = diagonal ? (Solver*)&w.diagonal_solver : (Solver*)&w.simple_solver;
+				solver->starting_coord = start;
+				for (int run = 1; run <= runs; run++) {
+					RunResult result = Run(solver, run != 1, max_steps, verify);
+					rows[index].push_back({ start, (bool)diagonal, run, result, solver->stats, -1.0f, -1.0f, 0 });
+					if (fast_run && solver->UpdateFinishedPaths()) {
+						RunRow& row = rows[index].back();
+						solver->SolutionWaypoints(w.waypoints);
+						if (w.compiler.Compile(w.waypoints, w.primitives)) {
+							row.solution_time = w.motion_model.RunTime(w.primitives);
+							row.solution_primitives = (int)w.primitives.size();
+						}
+						if (diagonal) {
+							w.diagonal_solver.FastRunWaypoints(w.waypoints);
+							if (w.compiler.Compile(w.waypoints, w.primitives)) {
+								row.fast_run_time = w.motion_model.RunTime(w.primitives);
+							}
+						}
+					}
+				}
+			}
+		}
+	});
+	auto end = std::chrono::steady_clock::now();
+
+	if (sweep) {
+		printf("\nSolver: %s\n", run_diagonal_solver && run_simple_solver ? "both" : run_diagonal_solver ? "diagonal" : "simple");
+		printf("%-40s %-11s %-9s %4s %8s %10s %12s  %s\n",
+			"maze", "start", "solver", "run", "steps", "floodfills", "time (ms)", "result");
+	} else {
+		printf("\nSolver: %s\n", run_diagonal_solver ? "diagonal" : "simple");
+		printf("%-40s %4s %8s %10s %12s  %s\n", "maze", "run", "steps", "floodfills", "time (ms)", "result");
+	}
+
+	bool stats_json = EndsWith(stats_filename, ".json");
+	std::string stats_out = stats_json ? "[\n" : "maze,start_x,start_y,solver,run,finished," + SolverStatsCsvHeader() + "\n";
+
+	double total_ms = 0.0;
+	size_t total_runs = 0;
+	SolverStats total_stats;
+	for (size_t i = 0; i < jobs.size(); i++) {
+		std::string maze_name;
+		if (jobs[i].file < 0) {
+			maze_name = std::string(MazeAlgorithmName(algorithm)) + "-" + std::to_string(generated_rows)
+				+ "x" + std::to_string(generated_cols) + "#" + std::to_string(seed + jobs[i].archive_index);
+		} else {
+			maze_name = filenames[jobs[i].file];
+			if (jobs[i].archive_index >= 0) {
+				maze_name += "#" + std::to_string(jobs[i].archive_index);
+			}
+		}
+		if (invalid[i]) {
+			std::cerr << "Invalid maze: " << maze_name << std::endl;
+			failures++;
+			continue;
+		}
+
+		for (RunRow& row : rows[i]) {
+			RunResult& result = row.result;
+			total_ms += result.ms;
+			total_runs++;
+			total_stats.flood_cache_hits += row.stats.flood_cache_hits;
+			total_stats.flood_cache_misses += row.stats.flood_cache_misses;
+			if (!result.finished || result.mismatches > 0) {
+				failures++;
+			}
+
+			std::string status = result.finished ? "finished" : "unfinished";
+			if (result.mismatches > 0) {
+				status += ", " + std::to_string(result.mismatches) + " floodfill mismatch(es)";
+			}
+			if (row.solution_time >= 0.0f) {
+				char times[96];
+				snprintf(times, sizeof(times), ", solution %.3f s (%d primitives)", row.solution_time, row.solution_primitives);
+				status += times;
+			}
+			if (row.fast_run_time >= 0.0f) {
+				char times[64];
+				snprintf(times, sizeof(times), ", fast run %.3f s", row.fast_run_time);
+				status += times;
+			}
+
+			const char* solver_name = row.diagonal ? "diagonal" : "simple";
+			std::string start_x = std::to_string(row.starting_coord.x);
+			std::string start_y = std::to_string(row.starting_coord.y);
+			if (stats_json) {
+				stats_out += std::string(total_runs > 1 ? ",\n" : "") + "  {\"maze\": " + JsonString(maze_name)
+					+ ", \"start\": [" + start_x + ", " + start_y + "], \"solver\": \"" + solver_name
+					+ "\", \"run\": " + std::to_string(row.run)
+					+ ", \"finished\": " + (result.finished ? "true" : "false")
+					+ ", \"stats\": " + SolverStatsToJson(row.stats) + "}";
+			} else {
+				stats_out += CsvField(maze_name) + "," + start_x + "," + start_y + "," + solver_name + ","
+					+ std::to_string(row.run) + "," + (result.finished ? "1" : "0") + ","
+					+ SolverStatsToCsv(row.stats) + "\n";
+			}
+
+			if (sweep) {
+				std::string start_name = "(" + start_x + ", " + start_y + ")";
+				printf(
+					"%-40s %-11s %-9s %4d %8d %10d %12.3f  %s\n",
+					maze_name.c_str(),
+					start_name.c_str(),
+					solver_name,
+					row.run,
+					result.steps,
+					result.floodfills,
+					result.ms,
+					status.c_str()
+				);
+			} else {
+				printf(
+					"%-40s %4d %8d %10d %12.3f  %s\n",
+					maze_name.c_str(),
+					row.run,
+					result.steps,
+					result.floodfills,
+					result.ms,
+					status.c_str()
+				);
+			}
+		}
+	}
+
+	if (!stats_filename.empty()) {
+		std::ofstream stats_file;
+		stats_file.open(stats_filename);
+		stats_file << stats_out << (stats_json ? "\n]\n" : "");
+		stats_file.close();
+		if (!stats_file) {
+			std::cerr << "Unable to write stats file: " << stats_filename << std::endl;
+			failures++;
+		}
+	}
+
+	double wall_ms = std::chrono::duration<double, std::milli>(end - start).count();
+	printf("Total: %zu run(s) in %.3f ms\n", total_runs, total_ms);
+	if (total_stats.flood_cache_hits + total_stats.flood_cache_misses > 0) {
+		printf(
+			"Flood cache: %lld hit(s), %lld miss(es), %.1f%% hit rate\n",
+			total_stats.flood_cache_hits,
+			total_stats.flood_cache_misses,
+			total_stats.FloodCacheHitRate() * 100.0
+		);
+	}
+	printf(
+		"Wall time: %.3f ms on %d thread(s), %.1f runs/s\n",
+		wall_ms,
+		(int)workers.size(),
+		wall_ms > 0.0 ? total_runs * 1000.0 / wall_ms : 0.0
+	);
+
+	return failures == 0 ? 0 : 1;
+}